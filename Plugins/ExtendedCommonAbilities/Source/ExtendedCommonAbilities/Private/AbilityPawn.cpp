@@ -7,6 +7,7 @@
 #include "AbilitySystemComponent.h"
 #include "ExtendedCommonAbilitiesModule.h"
 #include "PawnAbilityInputComponent.h"
+#include "Health/CommonHealthComponent.h"
 
 
 FName AAbilityPawn::PawnAbilityInputComponentName(TEXT("PawnAbilityInputComponent"));
@@ -16,6 +17,8 @@ AAbilityPawn::AAbilityPawn(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer.SetDefaultSubobjectClass(InitStateComponentName, UAbilitiesInitStateComponent::StaticClass()))
 {
 	PawnAbilityInputComponent = CreateDefaultSubobject<UPawnAbilityInputComponent>(PawnAbilityInputComponentName);
+
+	AbilitiesInitStateComponent = Cast<UAbilitiesInitStateComponent>(GetInitStateComponent());
 }
 
 void AAbilityPawn::PostLoad()
@@ -81,20 +84,32 @@ bool AAbilityPawn::HasAnyMatchingGameplayTags(const FGameplayTagContainer& TagCo
 
 UAbilitySystemComponent* AAbilityPawn::GetAbilitySystemComponent() const
 {
-	return GetAbilitiesInitStateComponent()->GetAbilitySystemComponent();
+	// the init state component holds the ability system only while initialized
+	return AbilitiesInitStateComponent ? AbilitiesInitStateComponent->GetAbilitySystemComponent() : nullptr;
 }
 
-UAbilitiesInitStateComponent* AAbilityPawn::GetAbilitiesInitStateComponent() const
+UCommonHealthComponent* AAbilityPawn::GetHealthComponent() const
 {
-	return Cast<UAbilitiesInitStateComponent>(GetInitStateComponent());
+	if (IsValid(HealthComponent))
+	{
+		return HealthComponent;
+	}
+
+	// the component may have been added after components were initialized
+	return FindComponentByClass<UCommonHealthComponent>();
 }
 
 void AAbilityPawn::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 
-	GetAbilitiesInitStateComponent()->OnAbilitySystemInitializedEvent.AddUObject(this, &ThisClass::OnInitializeAbilitySystem);
-	GetAbilitiesInitStateComponent()->OnAbilitySystemUninitializedEvent.AddUObject(this, &ThisClass::OnUninitializeAbilitySystem);
+	HealthComponent = FindComponentByClass<UCommonHealthComponent>();
+
+	if (AbilitiesInitStateComponent)
+	{
+		AbilitiesInitStateComponent->OnAbilitySystemInitializedEvent.AddUObject(this, &ThisClass::OnInitializeAbilitySystem);
+		AbilitiesInitStateComponent->OnAbilitySystemUninitializedEvent.AddUObject(this, &ThisClass::OnUninitializeAbilitySystem);
+	}
 }
 
 void AAbilityPawn::OnInitializeAbilitySystem()
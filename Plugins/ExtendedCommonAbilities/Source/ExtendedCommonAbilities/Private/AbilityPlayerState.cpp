@@ -4,7 +4,9 @@
 #include "AbilityPlayerState.h"
 
 #include "ExtendedAbilitySystemComponent.h"
+#include "GameFramework/Pawn.h"
 #include "Net/UnrealNetwork.h"
+#include "Teams/CommonTeamsComponent.h"
 #include "Teams/CommonTeamStatics.h"
 
 
@@ -20,6 +22,27 @@ AAbilityPlayerState::AAbilityPlayerState(const FObjectInitializer& ObjectInitial
 	SetNetUpdateFrequency(100.f);
 }
 
+void AAbilityPlayerState::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	OnPawnSet.AddDynamic(this, &AAbilityPlayerState::OnPawnChanged);
+}
+
+void AAbilityPlayerState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UpdateTeamsComponent();
+}
+
+void AAbilityPlayerState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	RemoveFromTeamsComponent();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 UAbilitySystemComponent* AAbilityPlayerState::GetAbilitySystemComponent() const
 {
 	return AbilitySystem;
@@ -60,10 +83,51 @@ void AAbilityPlayerState::BroadcastTeamChanged(const FGenericTeamId& NewTeamId,
 {
 	const int32 OldIdInt = UCommonTeamStatics::GenericTeamIdToInteger(OldTeamId);
 	const int32 NewIdInt = UCommonTeamStatics::GenericTeamIdToInteger(NewTeamId);
+	UpdateTeamsComponent();
+
 	OnTeamChangedEvent.Broadcast(this, NewIdInt, OldIdInt);
 	OnTeamChangedEvent_BP.Broadcast(this, NewIdInt, OldIdInt);
 }
 
+void AAbilityPlayerState::OnPawnChanged(APlayerState* Player, APawn* NewPawn, APawn* OldPawn)
+{
+	UpdateTeamsComponent(OldPawn);
+}
+
+void AAbilityPlayerState::UpdateTeamsComponent(const APawn* OldPawn)
+{
+	UCommonTeamsComponent* TeamsComp = UCommonTeamStatics::GetTeamsComponent(this);
+	if (!TeamsComp)
+	{
+		return;
+	}
+
+	TeamsComp->UpdatePlayerTeamCount(this);
+	TeamsComp->SetCachedTeamId(this, TeamId);
+
+	if (OldPawn)
+	{
+		TeamsComp->RemoveCachedTeamId(OldPawn);
+	}
+
+	// pawns that implement their own team interface may not use this player's team
+	const APawn* MyPawn = GetPawn();
+	if (MyPawn && !Cast<IGenericTeamAgentInterface>(MyPawn))
+	{
+		TeamsComp->SetCachedTeamId(MyPawn, TeamId);
+	}
+}
+
+void AAbilityPlayerState::RemoveFromTeamsComponent()
+{
+	if (UCommonTeamsComponent* TeamsComp = UCommonTeamStatics::GetTeamsComponent(this))
+	{
+		TeamsComp->RemovePlayerTeamCount(this);
+		TeamsComp->RemoveCachedTeamId(this);
+		TeamsComp->RemoveCachedTeamId(GetPawn());
+	}
+}
+
 void AAbilityPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
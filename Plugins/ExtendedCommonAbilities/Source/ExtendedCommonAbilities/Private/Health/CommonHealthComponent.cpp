@@ -3,6 +3,8 @@
 
 #include "Health/CommonHealthComponent.h"
 
+#include "AbilityCharacter.h"
+#include "AbilityPawn.h"
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
 #include "AbilitySystemLog.h"
@@ -240,3 +242,19 @@ void UCommonHealthComponent::OnHPChanged(const FOnAttributeChangeData& ChangeDat
 		}
 	}
 }
+
+UCommonHealthComponent* UCommonHealthComponent::GetHealthComponent(const AActor* Actor)
+{
+	// ability characters and pawns cache their health component
+	if (const AAbilityCharacter* AbilityCharacter = Cast<AAbilityCharacter>(Actor))
+	{
+		return AbilityCharacter->GetHealthComponent();
+	}
+
+	if (const AAbilityPawn* AbilityPawn = Cast<AAbilityPawn>(Actor))
+	{
+		return AbilityPawn->GetHealthComponent();
+	}
+
+	return Actor ? Actor->FindComponentByClass<UCommonHealthComponent>() : nullptr;
+}
@@ -5,6 +5,7 @@
 
 #include "ExtendedCommonAbilitiesTags.h"
 #include "NativeGameplayTags.h"
+#include "PawnInitStateSubsystem.h"
 #include "Components/GameFrameworkComponentManager.h"
 #include "Engine/GameInstance.h"
 #include "GameFramework/Controller.h"
@@ -67,7 +68,7 @@ void UPawnInitStateComponent::OnActorInitStateChanged(const FActorInitStateChang
 	{
 		if (Params.FeatureState == ExtendedCommonAbilities::GameplayTags::InitState_DataAvailable)
 		{
-			CheckDefaultInitialization();
+			RequestInitStateCheck();
 		}
 	}
 }
@@ -120,20 +121,35 @@ void UPawnInitStateComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// listen for pawn controller changes
-	GetGameInstance<UGameInstance>()->GetOnPawnControllerChanged().AddUniqueDynamic(this, &ThisClass::OnAnyPawnControllerChanged);
+	// listen for pawn controller changes, only for this pawn if possible
+	if (UPawnInitStateSubsystem* InitStateSubsystem = UWorld::GetSubsystem<UPawnInitStateSubsystem>(GetWorld()))
+	{
+		InitStateSubsystem->RegisterControllerChangeListener(this);
+	}
+	else
+	{
+		GetGameInstance<UGameInstance>()->GetOnPawnControllerChanged().AddUniqueDynamic(this, &ThisClass::OnAnyPawnControllerChanged);
+	}
 
 	BindOnActorInitStateChanged(NAME_None, FGameplayTag(), false);
 
 	const bool bSuccess = TryToChangeInitState(ExtendedCommonAbilities::GameplayTags::InitState_Spawned);
 	ensureMsgf(bSuccess, TEXT("PawnInitStateComponent on %s failed to transition to Spawned init state."), *GetNameSafe(GetOwner()));
 
-	CheckDefaultInitialization();
+	RequestInitStateCheck();
 }
 
 void UPawnInitStateComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	GetGameInstance<UGameInstance>()->GetOnPawnControllerChanged().RemoveAll(this);
+	if (UPawnInitStateSubsystem* InitStateSubsystem = UWorld::GetSubsystem<UPawnInitStateSubsystem>(GetWorld()))
+	{
+		InitStateSubsystem->UnregisterControllerChangeListener(this);
+		InitStateSubsystem->CancelInitStateCheck(this);
+	}
+	else
+	{
+		GetGameInstance<UGameInstance>()->GetOnPawnControllerChanged().RemoveAll(this);
+	}
 
 	UnregisterInitStateFeature();
 
@@ -144,7 +160,7 @@ void UPawnInitStateComponent::OnAnyPawnControllerChanged(APawn* Pawn, AControlle
 {
 	if (Pawn == GetPawn<APawn>())
 	{
-		CheckDefaultInitialization();
+		RequestInitStateCheck();
 	}
 }
 
@@ -153,17 +169,31 @@ UPawnInitStateComponent* UPawnInitStateComponent::GetPawnInitStateComponent(cons
 	return Actor ? Actor->FindComponentByClass<UPawnInitStateComponent>() : nullptr;
 }
 
-void UPawnInitStateComponent::NotifyControllerChanged()
+void UPawnInitStateComponent::RequestInitStateCheck()
 {
+	if (bDeferInitStateChecks)
+	{
+		if (UPawnInitStateSubsystem* InitStateSubsystem = UWorld::GetSubsystem<UPawnInitStateSubsystem>(GetWorld()))
+		{
+			InitStateSubsystem->RequestInitStateCheck(this);
+			return;
+		}
+	}
+
 	CheckDefaultInitialization();
 }
 
+void UPawnInitStateComponent::NotifyControllerChanged()
+{
+	RequestInitStateCheck();
+}
+
 void UPawnInitStateComponent::NotifyPlayerStateReplicated()
 {
-	CheckDefaultInitialization();
+	RequestInitStateCheck();
 }
 
 void UPawnInitStateComponent::NotifySetupPlayerInputComponent(UInputComponent* InputComponent)
 {
-	CheckDefaultInitialization();
+	RequestInitStateCheck();
 }
@@ -0,0 +1,177 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "PawnInitStateSubsystem.h"
+
+#include "ExtendedCommonAbilitiesModule.h"
+#include "PawnInitStateComponent.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("Process Pawn Init States"), STAT_PawnInitStateSubsystem_Process, STATGROUP_ExtendedCommonAbilities);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pawn Init State Checks"), STAT_PawnInitStateChecks, STATGROUP_ExtendedCommonAbilities);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pawn Init State Checks Skipped"), STAT_PawnInitStateChecksSkipped, STATGROUP_ExtendedCommonAbilities);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pawn Controller Change Listeners"), STAT_PawnControllerChangeListeners, STATGROUP_ExtendedCommonAbilities);
+
+
+void UPawnInitStateSubsystem::Deinitialize()
+{
+	if (bIsBoundToPawnControllerChanged)
+	{
+		if (UGameInstance* GameInstance = GetWorld()->GetGameInstance())
+		{
+			GameInstance->GetOnPawnControllerChanged().RemoveAll(this);
+		}
+		bIsBoundToPawnControllerChanged = false;
+	}
+
+	DEC_DWORD_STAT_BY(STAT_PawnControllerChangeListeners, NumControllerChangeListeners);
+	ControllerChangeListeners.Reset();
+	NumControllerChangeListeners = 0;
+
+	Super::Deinitialize();
+}
+
+void UPawnInitStateSubsystem::RegisterControllerChangeListener(UPawnInitStateComponent* Component)
+{
+	check(Component);
+
+	APawn* Pawn = Component->GetPawn<APawn>();
+	if (!Pawn)
+	{
+		return;
+	}
+
+	// bind once for the world, instead of once per component
+	if (!bIsBoundToPawnControllerChanged)
+	{
+		if (UGameInstance* GameInstance = GetWorld()->GetGameInstance())
+		{
+			GameInstance->GetOnPawnControllerChanged().AddUniqueDynamic(this, &ThisClass::OnPawnControllerChanged);
+			bIsBoundToPawnControllerChanged = true;
+		}
+	}
+
+	auto& Listeners = ControllerChangeListeners.FindOrAdd(Pawn);
+	if (!Listeners.Contains(Component))
+	{
+		Listeners.Add(Component);
+		++NumControllerChangeListeners;
+		INC_DWORD_STAT(STAT_PawnControllerChangeListeners);
+	}
+}
+
+void UPawnInitStateSubsystem::UnregisterControllerChangeListener(UPawnInitStateComponent* Component)
+{
+	const APawn* Pawn = Component ? Component->GetPawn<APawn>() : nullptr;
+	if (!Pawn)
+	{
+		return;
+	}
+
+	auto* Listeners = ControllerChangeListeners.Find(Pawn);
+	if (Listeners && Listeners->RemoveSingleSwap(Component))
+	{
+		--NumControllerChangeListeners;
+		DEC_DWORD_STAT(STAT_PawnControllerChangeListeners);
+
+		if (Listeners->IsEmpty())
+		{
+			ControllerChangeListeners.Remove(Pawn);
+		}
+	}
+}
+
+void UPawnInitStateSubsystem::OnPawnControllerChanged(APawn* Pawn, AController* Controller)
+{
+	const auto* Listeners = ControllerChangeListeners.Find(Pawn);
+	if (!Listeners)
+	{
+		return;
+	}
+
+	// copy, since notified components may unregister
+	const TArray<TWeakObjectPtr<UPawnInitStateComponent>, TInlineAllocator<1>> ListenersCopy = *Listeners;
+	for (const TWeakObjectPtr<UPawnInitStateComponent>& Component : ListenersCopy)
+	{
+		if (Component.IsValid())
+		{
+			Component->OnAnyPawnControllerChanged(Pawn, Controller);
+		}
+	}
+}
+
+void UPawnInitStateSubsystem::RequestInitStateCheck(UPawnInitStateComponent* Component)
+{
+	check(Component);
+
+	bool bIsAlreadyPending = false;
+	PendingComponents.Add(Component, &bIsAlreadyPending);
+
+	if (bIsAlreadyPending)
+	{
+		++NumSkippedInitStateChecks;
+		INC_DWORD_STAT(STAT_PawnInitStateChecksSkipped);
+	}
+}
+
+void UPawnInitStateSubsystem::CancelInitStateCheck(UPawnInitStateComponent* Component)
+{
+	PendingComponents.Remove(Component);
+}
+
+void UPawnInitStateSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ProcessPendingComponents();
+}
+
+bool UPawnInitStateSubsystem::IsTickable() const
+{
+	return !PendingComponents.IsEmpty();
+}
+
+bool UPawnInitStateSubsystem::IsTickableWhenPaused() const
+{
+	// deferred checks would otherwise stall while paused, unlike immediate checks
+	return true;
+}
+
+ETickableTickType UPawnInitStateSubsystem::GetTickableTickType() const
+{
+	// don't tick the CDO
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UPawnInitStateSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPawnInitStateSubsystem, STATGROUP_Tickables);
+}
+
+bool UPawnInitStateSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UPawnInitStateSubsystem::ProcessPendingComponents()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PawnInitStateSubsystem_Process);
+
+	// checks can change init states, which may request more checks for other components
+	while (!PendingComponents.IsEmpty())
+	{
+		TSet<TWeakObjectPtr<UPawnInitStateComponent>> ComponentsToCheck = MoveTemp(PendingComponents);
+		PendingComponents.Reset();
+
+		for (const TWeakObjectPtr<UPawnInitStateComponent>& Component : ComponentsToCheck)
+		{
+			if (Component.IsValid())
+			{
+				INC_DWORD_STAT(STAT_PawnInitStateChecks);
+				Component->CheckDefaultInitialization();
+			}
+		}
+	}
+}
@@ -0,0 +1,14 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "Teams/CommonTeamRelationships.h"
+
+
+ETeamAttitude::Type UCommonTeamRelationships::GetAttitudeTowards(uint8 OwnTeamId, uint8 OtherTeamId) const
+{
+	if (const TEnumAsByte<ETeamAttitude::Type>* Attitude = TeamAttitudes.Find(OtherTeamId))
+	{
+		return *Attitude;
+	}
+	return OwnTeamId == OtherTeamId ? SelfAttitude : DefaultAttitude;
+}
@@ -4,17 +4,17 @@
 #include "Teams/CommonTeamStatics.h"
 
 #include "Engine/Engine.h"
-#include "GameFramework/GameStateBase.h"
 #include "Teams/CommonTeamsComponent.h"
+#include "Teams/CommonTeamsSubsystem.h"
 
 
 UCommonTeamsComponent* UCommonTeamStatics::GetTeamsComponent(const UObject* WorldContextObject)
 {
 	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull))
 	{
-		if (const AGameStateBase* GameState = World->GetGameState())
+		if (const UCommonTeamsSubsystem* TeamsSubsystem = World->GetSubsystem<UCommonTeamsSubsystem>())
 		{
-			return GameState->FindComponentByClass<UCommonTeamsComponent>();
+			return TeamsSubsystem->GetTeamsComponent();
 		}
 	}
 	return nullptr;
@@ -24,8 +24,10 @@ void UCommonTeamStatics::CompareTeams(const UObject* ObjectA, const UObject* Obj
 {
 	if (const UCommonTeamsComponent* TeamsComp = GetTeamsComponent(ObjectA))
 	{
-		Attitude = TeamsComp->GetAttitude(ObjectA, ObjectB);
-		Comparison = TeamsComp->CompareTeams(ObjectA, ObjectB);
+		const FGenericTeamId TeamIdA = TeamsComp->GetObjectGenericTeamId(ObjectA);
+		const FGenericTeamId TeamIdB = TeamsComp->GetObjectGenericTeamId(ObjectB);
+		Attitude = TeamsComp->GetTeamAttitude(TeamIdA, TeamIdB);
+		Comparison = UCommonTeamsComponent::CompareTeamIds(TeamIdA, TeamIdB);
 	}
 	else
 	{
@@ -4,14 +4,22 @@
 #include "Teams/CommonTeamsComponent.h"
 
 #include "GenericTeamAgentInterface.h"
+#include "Engine/World.h"
 #include "Framework/Commands/GenericCommands.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameStateBase.h"
 #include "GameFramework/PlayerState.h"
+#include "Teams/CommonTeamDef.h"
+#include "Teams/CommonTeamRelationships.h"
+#include "Teams/CommonTeamsSubsystem.h"
 #include "Teams/CommonTeamStatics.h"
 
 
 UCommonTeamsComponent::UCommonTeamsComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	TeamMemberCounts.Init(0, 256);
 }
 
 const UCommonTeamDef* UCommonTeamsComponent::GetTeamDefinition(int32 TeamId) const
@@ -19,10 +27,129 @@ const UCommonTeamDef* UCommonTeamsComponent::GetTeamDefinition(int32 TeamId) con
 	return TeamDefinitions.FindRef(TeamId);
 }
 
+void UCommonTeamsComponent::SetTeamDefinition(int32 TeamId, const UCommonTeamDef* TeamDef)
+{
+	if (TeamId < 0 || TeamId >= FGenericTeamId::NoTeam.GetId())
+	{
+		return;
+	}
+
+	if (TeamDef)
+	{
+		TeamDefinitions.Add(TeamId, TeamDef);
+	}
+	else
+	{
+		TeamDefinitions.Remove(TeamId);
+	}
+
+	MarkTeamAttitudesDirty(static_cast<uint8>(TeamId));
+}
+
+void UCommonTeamsComponent::RebuildTeamAttitudes()
+{
+	bAllTeamAttitudesDirty = true;
+	bHasDirtyTeamAttitudes = true;
+}
+
+void UCommonTeamsComponent::MarkTeamAttitudesDirty(uint8 TeamId)
+{
+	if (DirtyAttitudeTeams.IsEmpty())
+	{
+		DirtyAttitudeTeams.Init(false, 256);
+	}
+
+	DirtyAttitudeTeams[TeamId] = true;
+	bHasDirtyTeamAttitudes = true;
+}
+
+void UCommonTeamsComponent::UpdateDirtyTeamAttitudes() const
+{
+	if (bAllTeamAttitudesDirty || TeamAttitudes.IsEmpty())
+	{
+		TeamAttitudes.SetNumUninitialized(256 * 256);
+
+		for (int32 IdA = 0; IdA < 256; ++IdA)
+		{
+			for (int32 IdB = 0; IdB < 256; ++IdB)
+			{
+				const FGenericTeamId TeamIdA(static_cast<uint8>(IdA));
+				const FGenericTeamId TeamIdB(static_cast<uint8>(IdB));
+				TeamAttitudes[GetTeamPairIndex(TeamIdA, TeamIdB)] = ComputeTeamAttitude(TeamIdA, TeamIdB);
+			}
+		}
+	}
+	else
+	{
+		// a team's definition affects its attitude towards others, and may affect others' attitudes towards it
+		for (TConstSetBitIterator<> It(DirtyAttitudeTeams); It; ++It)
+		{
+			const FGenericTeamId DirtyTeamId(static_cast<uint8>(It.GetIndex()));
+			for (int32 Id = 0; Id < 256; ++Id)
+			{
+				const FGenericTeamId OtherTeamId(static_cast<uint8>(Id));
+				TeamAttitudes[GetTeamPairIndex(DirtyTeamId, OtherTeamId)] = ComputeTeamAttitude(DirtyTeamId, OtherTeamId);
+				TeamAttitudes[GetTeamPairIndex(OtherTeamId, DirtyTeamId)] = ComputeTeamAttitude(OtherTeamId, DirtyTeamId);
+			}
+		}
+	}
+
+	DirtyAttitudeTeams.SetRange(0, DirtyAttitudeTeams.Num(), false);
+	bAllTeamAttitudesDirty = false;
+	bHasDirtyTeamAttitudes = false;
+}
+
+ETeamAttitude::Type UCommonTeamsComponent::ComputeTeamAttitude(const FGenericTeamId& TeamIdA, const FGenericTeamId& TeamIdB) const
+{
+	if (TeamIdA == FGenericTeamId::NoTeam || TeamIdB == FGenericTeamId::NoTeam)
+	{
+		return ETeamAttitude::Neutral;
+	}
+
+	const UCommonTeamDef* TeamDefA = TeamDefinitions.FindRef(TeamIdA.GetId());
+	if (TeamDefA && TeamDefA->Relationships)
+	{
+		return TeamDefA->Relationships->GetAttitudeTowards(TeamIdA.GetId(), TeamIdB.GetId());
+	}
+
+	return FGenericTeamId::GetAttitude(TeamIdA, TeamIdB);
+}
+
+void UCommonTeamsComponent::OnRegister()
+{
+	Super::OnRegister();
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &UCommonTeamsComponent::OnObjectPropertyChanged);
+#endif
+
+	if (UCommonTeamsSubsystem* TeamsSubsystem = UWorld::GetSubsystem<UCommonTeamsSubsystem>(GetWorld()))
+	{
+		TeamsSubsystem->RegisterTeamsComponent(this);
+	}
+}
+
+void UCommonTeamsComponent::OnUnregister()
+{
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+#endif
+
+	if (UCommonTeamsSubsystem* TeamsSubsystem = UWorld::GetSubsystem<UCommonTeamsSubsystem>(GetWorld()))
+	{
+		TeamsSubsystem->UnregisterTeamsComponent(this);
+	}
+
+	Super::OnUnregister();
+}
+
 void UCommonTeamsComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// the attitude solver is usually set up by now, and may have changed since the table was built
+	RebuildTeamAttitudes();
+
 	StartTeamSetup();
 }
 
@@ -31,10 +158,26 @@ void UCommonTeamsComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	Super::EndPlay(EndPlayReason);
 
 	FGameModeEvents::GameModePostLoginEvent.RemoveAll(this);
+	FGameModeEvents::GameModeLogoutEvent.RemoveAll(this);
+
+	CachedTeamIds.Reset();
+	CountedPlayerTeams.Reset();
+}
+
+#if WITH_EDITOR
+void UCommonTeamsComponent::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	if (Cast<UCommonTeamDef>(Object) || Cast<UCommonTeamRelationships>(Object))
+	{
+		RebuildTeamAttitudes();
+	}
 }
+#endif
 
 void UCommonTeamsComponent::StartTeamSetup()
 {
+	RebuildTeamMemberCounts();
+
 	if (HasAuthority())
 	{
 		// setup immediately, you may want to delay this until everything is ready in some situations
@@ -42,6 +185,7 @@ void UCommonTeamsComponent::StartTeamSetup()
 
 		// listen for new player logins
 		FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &UCommonTeamsComponent::OnPlayerPostLogin);
+		FGameModeEvents::GameModeLogoutEvent.AddUObject(this, &UCommonTeamsComponent::OnPlayerLogout);
 	}
 }
 
@@ -58,52 +202,76 @@ int32 UCommonTeamsComponent::SelectTeamForPlayer_Implementation(APlayerState* Pl
 
 int32 UCommonTeamsComponent::GetLeastPopulatedTeam() const
 {
-	if (TeamDefinitions.IsEmpty())
+	// return the lowest count, or the lowest-number team ID if counts match
+	int32 BestId = INDEX_NONE;
+	int32 LowestCount = MAX_int32;
+	for (const auto& Elem : TeamDefinitions)
 	{
-		return INDEX_NONE;
+		const int32 TeamId = Elem.Key;
+		const int32 MemberCount = TeamMemberCounts[TeamId];
+		if (MemberCount < LowestCount || (MemberCount == LowestCount && TeamId < BestId))
+		{
+			BestId = TeamId;
+			LowestCount = MemberCount;
+		}
 	}
+	return BestId;
+}
 
-	TMap<int32, uint32> TeamMemberCounts;
-	TeamMemberCounts.Reserve(TeamDefinitions.Num());
+int32 UCommonTeamsComponent::GetTeamMemberCount(int32 TeamId) const
+{
+	return TeamMemberCounts.IsValidIndex(TeamId) ? TeamMemberCounts[TeamId] : 0;
+}
 
-	for (const auto& Elem : TeamDefinitions)
+void UCommonTeamsComponent::UpdatePlayerTeamCount(const APlayerState* PlayerState)
+{
+	if (!PlayerState)
 	{
-		TeamMemberCounts.Add(Elem.Key, 0);
+		return;
 	}
 
-	AGameStateBase* GameState = GetGameStateChecked<AGameStateBase>();
-	for (const TObjectPtr<APlayerState>& PlayerState : GameState->PlayerArray)
+	const IGenericTeamAgentInterface* TeamInterface = Cast<IGenericTeamAgentInterface>(PlayerState);
+	const uint8 NewTeamId = TeamInterface && !PlayerState->IsInactive() ? TeamInterface->GetGenericTeamId().GetId() : FGenericTeamId::NoTeam.GetId();
+
+	if (const uint8* CountedTeamId = CountedPlayerTeams.Find(PlayerState))
 	{
-		if (PlayerState->IsInactive())
+		if (*CountedTeamId == NewTeamId)
 		{
-			continue;
+			return;
 		}
+		--TeamMemberCounts[*CountedTeamId];
+	}
 
-		// find members
-		if (const IGenericTeamAgentInterface* TeamInterface = Cast<IGenericTeamAgentInterface>(PlayerState))
-		{
-			const uint8 TeamId = TeamInterface->GetGenericTeamId().GetId();
-			if (TeamMemberCounts.Contains(TeamId))
-			{
-				TeamMemberCounts[TeamId]++;
-			}
-		}
+	if (NewTeamId == FGenericTeamId::NoTeam.GetId())
+	{
+		CountedPlayerTeams.Remove(PlayerState);
+	}
+	else
+	{
+		CountedPlayerTeams.Add(PlayerState, NewTeamId);
+		++TeamMemberCounts[NewTeamId];
 	}
+}
 
-	// return the lowest count, or the lowest-number team ID if counts match
-	int32 BestId = INDEX_NONE;
-	uint32 LowestCount = TNumericLimits<uint32>::Max();
-	for (const TPair<int32, uint32>& Elem : TeamMemberCounts)
+void UCommonTeamsComponent::RemovePlayerTeamCount(const APlayerState* PlayerState)
+{
+	uint8 CountedTeamId;
+	if (CountedPlayerTeams.RemoveAndCopyValue(PlayerState, CountedTeamId))
 	{
-		const int32 TeamId = Elem.Key;
-		const uint32 MemberCount = Elem.Value;
-		if (MemberCount < LowestCount || BestId == INDEX_NONE || TeamId < BestId)
-		{
-			BestId = TeamId;
-			LowestCount = MemberCount;
-		}
+		--TeamMemberCounts[CountedTeamId];
+	}
+}
+
+void UCommonTeamsComponent::RebuildTeamMemberCounts()
+{
+	CountedPlayerTeams.Reset();
+	TeamMemberCounts.Init(0, 256);
+
+	const AGameStateBase* GameState = GetGameStateChecked<AGameStateBase>();
+	for (const TObjectPtr<APlayerState>& PlayerState : GameState->PlayerArray)
+	{
+		UpdatePlayerTeamCount(PlayerState);
 	}
-	return BestId;
 }
 
 IGenericTeamAgentInterface* UCommonTeamsComponent::GetTeamInterfaceForObject(UObject* Object) const
@@ -143,6 +311,11 @@ const IGenericTeamAgentInterface* UCommonTeamsComponent::GetTeamInterfaceForObje
 
 FGenericTeamId UCommonTeamsComponent::GetObjectGenericTeamId(const UObject* Object) const
 {
+	if (const uint8* CachedTeamId = CachedTeamIds.Find(Object))
+	{
+		return FGenericTeamId(*CachedTeamId);
+	}
+
 	if (const IGenericTeamAgentInterface* TeamInterface = GetTeamInterfaceForObject(Object))
 	{
 		return TeamInterface->GetGenericTeamId();
@@ -150,6 +323,19 @@ FGenericTeamId UCommonTeamsComponent::GetObjectGenericTeamId(const UObject* Obje
 	return FGenericTeamId::NoTeam;
 }
 
+void UCommonTeamsComponent::SetCachedTeamId(const UObject* Object, const FGenericTeamId& TeamId)
+{
+	if (Object)
+	{
+		CachedTeamIds.Add(Object, TeamId.GetId());
+	}
+}
+
+void UCommonTeamsComponent::RemoveCachedTeamId(const UObject* Object)
+{
+	CachedTeamIds.Remove(Object);
+}
+
 int32 UCommonTeamsComponent::GetObjectTeam(const UObject* Object) const
 {
 	return UCommonTeamStatics::GenericTeamIdToInteger(GetObjectGenericTeamId(Object));
@@ -165,21 +351,17 @@ void UCommonTeamsComponent::SetObjectTeam(UObject* Object, int32 NewTeamId)
 
 TEnumAsByte<ETeamAttitude::Type> UCommonTeamsComponent::GetAttitude(const UObject* ObjectA, const UObject* ObjectB) const
 {
-	const FGenericTeamId TeamIdA = GetObjectGenericTeamId(ObjectA);
-	const FGenericTeamId TeamIdB = GetObjectGenericTeamId(ObjectB);
-	if (TeamIdA == FGenericTeamId::NoTeam || TeamIdB == FGenericTeamId::NoTeam)
-	{
-		return ETeamAttitude::Neutral;
-	}
-	return FGenericTeamId::GetAttitude(TeamIdA, TeamIdB);
+	return GetTeamAttitude(GetObjectGenericTeamId(ObjectA), GetObjectGenericTeamId(ObjectB));
 }
 
 ECommonTeamComparison UCommonTeamsComponent::CompareTeams(const UObject* ObjectA, const UObject* ObjectB) const
 {
-	const int32 TeamIdA = GetObjectTeam(ObjectA);
-	const int32 TeamIdB = GetObjectTeam(ObjectB);
+	return CompareTeamIds(GetObjectGenericTeamId(ObjectA), GetObjectGenericTeamId(ObjectB));
+}
 
-	if (TeamIdA == INDEX_NONE || TeamIdB == INDEX_NONE)
+ECommonTeamComparison UCommonTeamsComponent::CompareTeamIds(const FGenericTeamId& TeamIdA, const FGenericTeamId& TeamIdB)
+{
+	if (TeamIdA == FGenericTeamId::NoTeam || TeamIdB == FGenericTeamId::NoTeam)
 	{
 		return ECommonTeamComparison::NoTeam;
 	}
@@ -187,6 +369,59 @@ ECommonTeamComparison UCommonTeamsComponent::CompareTeams(const UObject* ObjectA
 	return TeamIdA == TeamIdB ? ECommonTeamComparison::SameTeam : ECommonTeamComparison::DifferentTeams;
 }
 
+void UCommonTeamsComponent::CompareTeamsBatch(const UObject* Observer, const TArray<AActor*>& Targets,
+                                              TArray<TEnumAsByte<ETeamAttitude::Type>>& OutAttitudes,
+                                              TArray<ECommonTeamComparison>& OutComparisons) const
+{
+	TArray<uint8, TInlineAllocator<256>> TargetTeamIds;
+	GetObjectTeamIds(Targets, TargetTeamIds);
+
+	// all attitudes for the observer are in one row of the table
+	UpdateTeamAttitudesIfDirty();
+	const uint8 ObserverTeamId = GetObjectGenericTeamId(Observer).GetId();
+	const uint8* AttitudeRow = &TeamAttitudes[GetTeamPairIndex(ObserverTeamId, 0)];
+	const bool bObserverHasTeam = ObserverTeamId != FGenericTeamId::NoTeam.GetId();
+
+	OutAttitudes.SetNumUninitialized(Targets.Num());
+	OutComparisons.SetNumUninitialized(Targets.Num());
+	for (int32 Idx = 0; Idx < TargetTeamIds.Num(); ++Idx)
+	{
+		const uint8 TargetTeamId = TargetTeamIds[Idx];
+		OutAttitudes[Idx] = static_cast<ETeamAttitude::Type>(AttitudeRow[TargetTeamId]);
+		OutComparisons[Idx] = !bObserverHasTeam || TargetTeamId == FGenericTeamId::NoTeam.GetId()
+			                      ? ECommonTeamComparison::NoTeam
+			                      : TargetTeamId == ObserverTeamId
+			                      ? ECommonTeamComparison::SameTeam
+			                      : ECommonTeamComparison::DifferentTeams;
+	}
+}
+
+void UCommonTeamsComponent::FilterTeamsBatch(const UObject* Observer, const TArray<AActor*>& Targets,
+                                             int32 AttitudeMask, int32 ComparisonMask, TArray<int32>& OutIndices) const
+{
+	TArray<uint8, TInlineAllocator<256>> TargetTeamIds;
+	GetObjectTeamIds(Targets, TargetTeamIds);
+
+	// build a row of which target team ids pass both masks, so each target is a single lookup
+	const FGenericTeamId ObserverTeamId = GetObjectGenericTeamId(Observer);
+	bool PassingTeams[256];
+	for (int32 TeamId = 0; TeamId < 256; ++TeamId)
+	{
+		const FGenericTeamId TargetTeamId(static_cast<uint8>(TeamId));
+		PassingTeams[TeamId] = FCommonTeamTypes::MatchesAttitudeMask(GetTeamAttitude(ObserverTeamId, TargetTeamId), static_cast<uint8>(AttitudeMask)) &&
+			FCommonTeamTypes::MatchesComparisonMask(CompareTeamIds(ObserverTeamId, TargetTeamId), static_cast<uint8>(ComparisonMask));
+	}
+
+	OutIndices.Reset(Targets.Num());
+	for (int32 Idx = 0; Idx < TargetTeamIds.Num(); ++Idx)
+	{
+		if (PassingTeams[TargetTeamIds[Idx]])
+		{
+			OutIndices.Add(Idx);
+		}
+	}
+}
+
 void UCommonTeamsComponent::AssignTeamsForPlayers()
 {
 	AGameStateBase* GameState = GetGameStateChecked<AGameStateBase>();
@@ -207,6 +442,62 @@ void UCommonTeamsComponent::AssignTeamForPlayer(APlayerState* PlayerState)
 	{
 		const FGenericTeamId TeamId = UCommonTeamStatics::IntegerToGenericTeamId(SelectTeamForPlayer(PlayerState));
 		TeamInterface->SetGenericTeamId(TeamId);
+
+		// the player state may not report its team change
+		UpdatePlayerTeamCount(PlayerState);
+	}
+}
+
+void UCommonTeamsComponent::BalanceTeamsForPlayers()
+{
+	if (!ensure(HasAuthority()))
+	{
+		return;
+	}
+
+	TArray<uint8, TInlineAllocator<16>> TeamIds;
+	for (const auto& Elem : TeamDefinitions)
+	{
+		TeamIds.Add(Elem.Key);
+	}
+	TeamIds.Sort();
+
+	// count as we go, starting from empty teams
+	TArray<int32, TInlineAllocator<16>> Counts;
+	Counts.SetNumZeroed(TeamIds.Num());
+
+	const AGameStateBase* GameState = GetGameStateChecked<AGameStateBase>();
+	for (const TObjectPtr<APlayerState>& PlayerState : GameState->PlayerArray)
+	{
+		IGenericTeamAgentInterface* TeamInterface = Cast<IGenericTeamAgentInterface>(PlayerState);
+		if (!TeamInterface || PlayerState->IsInactive())
+		{
+			continue;
+		}
+
+		int32 BestIdx = INDEX_NONE;
+		if (!PlayerState->IsOnlyASpectator())
+		{
+			for (int32 Idx = 0; Idx < TeamIds.Num(); ++Idx)
+			{
+				if (BestIdx == INDEX_NONE || Counts[Idx] < Counts[BestIdx])
+				{
+					BestIdx = Idx;
+				}
+			}
+		}
+
+		if (BestIdx != INDEX_NONE)
+		{
+			++Counts[BestIdx];
+			TeamInterface->SetGenericTeamId(FGenericTeamId(TeamIds[BestIdx]));
+		}
+		else
+		{
+			TeamInterface->SetGenericTeamId(FGenericTeamId::NoTeam);
+		}
+
+		UpdatePlayerTeamCount(PlayerState);
 	}
 }
 
@@ -217,3 +508,11 @@ void UCommonTeamsComponent::OnPlayerPostLogin(AGameModeBase* GameMode, APlayerCo
 		AssignTeamForPlayer(NewPlayer->PlayerState);
 	}
 }
+
+void UCommonTeamsComponent::OnPlayerLogout(AGameModeBase* GameMode, AController* Exiting)
+{
+	if (Exiting && Exiting->PlayerState)
+	{
+		RemovePlayerTeamCount(Exiting->PlayerState);
+	}
+}
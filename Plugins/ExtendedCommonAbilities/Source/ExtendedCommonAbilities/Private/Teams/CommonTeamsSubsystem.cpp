@@ -0,0 +1,27 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "Teams/CommonTeamsSubsystem.h"
+
+#include "ExtendedCommonAbilitiesModule.h"
+#include "Teams/CommonTeamsComponent.h"
+
+
+void UCommonTeamsSubsystem::RegisterTeamsComponent(UCommonTeamsComponent* InTeamsComponent)
+{
+	if (TeamsComponent && TeamsComponent != InTeamsComponent)
+	{
+		UE_LOG(LogCommonAbilities, Warning, TEXT("Replacing registered teams component %s with %s, only one teams component is supported per world."),
+		       *GetNameSafe(TeamsComponent), *GetNameSafe(InTeamsComponent));
+	}
+
+	TeamsComponent = InTeamsComponent;
+}
+
+void UCommonTeamsSubsystem::UnregisterTeamsComponent(UCommonTeamsComponent* InTeamsComponent)
+{
+	if (TeamsComponent == InTeamsComponent)
+	{
+		TeamsComponent = nullptr;
+	}
+}
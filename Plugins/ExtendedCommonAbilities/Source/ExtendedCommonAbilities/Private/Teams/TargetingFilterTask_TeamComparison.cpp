@@ -3,10 +3,14 @@
 
 #include "Teams/TargetingFilterTask_TeamComparison.h"
 
+#include "ExtendedCommonAbilitiesModule.h"
 #include "Teams/CommonTeamsComponent.h"
 #include "Teams/CommonTeamStatics.h"
 
 
+DECLARE_CYCLE_STAT(TEXT("TeamComparison Filter"), STAT_TargetingFilterTeamComparison, STATGROUP_ExtendedCommonAbilities);
+
+
 UTargetingFilterTask_TeamComparison::UTargetingFilterTask_TeamComparison(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -16,6 +20,8 @@ UTargetingFilterTask_TeamComparison::UTargetingFilterTask_TeamComparison(const F
 
 void UTargetingFilterTask_TeamComparison::Execute(const FTargetingRequestHandle& TargetingHandle) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_TargetingFilterTeamComparison);
+
 	// can't use the parent implementation, because it affects the target results order.
 	// note that debug display of filtered items is not implemented here.
 
@@ -25,15 +31,35 @@ void UTargetingFilterTask_TeamComparison::Execute(const FTargetingRequestHandle&
 	{
 		if (FTargetingDefaultResultsSet* ResultData = FTargetingDefaultResultsSet::Find(TargetingHandle))
 		{
-			const int32 NumTargets = ResultData->TargetResults.Num();
-			for (int32 TargetIterator = NumTargets - 1; TargetIterator >= 0; --TargetIterator)
+			TArray<FTargetingDefaultResultData>& TargetResults = ResultData->TargetResults;
+
+			// everything except the hit actor is the same for all targets, so resolve it once for ShouldFilterTarget.
+			// targeting tasks execute on the game thread, so only one request uses the context at a time
+			FTeamFilterContext Context;
+			Context.TargetingHandle = TargetingHandle;
+			const FTargetingSourceContext* SourceContext = FTargetingSourceContext::Find(TargetingHandle);
+			Context.Instigator = SourceContext ? SourceContext->InstigatorActor.Get() : nullptr;
+			Context.TeamsComp = FindTeamsComponent(SourceContext, TargetResults);
+			Context.InstigatorTeamId = Context.TeamsComp ? Context.TeamsComp->GetObjectGenericTeamId(Context.Instigator) : FGenericTeamId::NoTeam;
+			TGuardValue<FTeamFilterContext> ContextGuard(ExecutingContext, Context);
+
+			// compact the results in place, preserving order
+			const int32 NumTargets = TargetResults.Num();
+			int32 NumKept = 0;
+			for (int32 TargetIdx = 0; TargetIdx < NumTargets; ++TargetIdx)
 			{
-				const FTargetingDefaultResultData& TargetResult = ResultData->TargetResults[TargetIterator];
-				if (ShouldFilterTarget(TargetingHandle, TargetResult))
+				if (ShouldFilterTarget(TargetingHandle, TargetResults[TargetIdx]))
 				{
-					ResultData->TargetResults.RemoveAt(TargetIterator, EAllowShrinking::No);
+					continue;
 				}
+
+				if (NumKept != TargetIdx)
+				{
+					TargetResults[NumKept] = MoveTemp(TargetResults[TargetIdx]);
+				}
+				++NumKept;
 			}
+			TargetResults.SetNum(NumKept, EAllowShrinking::No);
 		}
 	}
 
@@ -44,31 +70,46 @@ bool UTargetingFilterTask_TeamComparison::ShouldFilterTarget(const FTargetingReq
                                                              const FTargetingDefaultResultData& TargetData) const
 {
 	const AActor* HitActor = TargetData.HitResult.GetActor();
+	if (ExecutingContext.TargetingHandle == TargetingHandle)
+	{
+		return ShouldFilterHitActor(ExecutingContext.TeamsComp, ExecutingContext.Instigator, ExecutingContext.InstigatorTeamId, HitActor);
+	}
+
+	const UCommonTeamsComponent* TeamsComp = HitActor ? UCommonTeamStatics::GetTeamsComponent(HitActor) : nullptr;
+
+	const FTargetingSourceContext* SourceContext = FTargetingSourceContext::Find(TargetingHandle);
+	const AActor* Instigator = SourceContext ? SourceContext->InstigatorActor.Get() : nullptr;
+	const FGenericTeamId InstigatorTeamId = TeamsComp ? TeamsComp->GetObjectGenericTeamId(Instigator) : FGenericTeamId::NoTeam;
+
+	return ShouldFilterHitActor(TeamsComp, Instigator, InstigatorTeamId, HitActor);
+}
+
+bool UTargetingFilterTask_TeamComparison::ShouldFilterHitActor(const UCommonTeamsComponent* TeamsComp, const AActor* Instigator,
+                                                               const FGenericTeamId& InstigatorTeamId, const AActor* HitActor) const
+{
 	if (!HitActor)
 	{
 		// require an actor to pass this filter
 		return !bIncludeNonBlockingHit;
 	}
 
-	const UCommonTeamsComponent* TeamsComp = UCommonTeamStatics::GetTeamsComponent(HitActor);
 	if (!TeamsComp)
 	{
 		// can't do anything without teams component, assume passed
 		return false;
 	}
 
-	const FTargetingSourceContext* SourceContext = FTargetingSourceContext::Find(TargetingHandle);
-	if (!SourceContext->InstigatorActor)
+	if (!Instigator)
 	{
 		// require an instigator
 		return true;
 	}
 
-	const AActor* Instigator = SourceContext->InstigatorActor.Get();
+	const FGenericTeamId HitTeamId = TeamsComp->GetObjectGenericTeamId(HitActor);
 
 	if (AttitudeMask != FCommonTeamTypes::AllAttitudesMask)
 	{
-		const ETeamAttitude::Type HitAttitude = TeamsComp->GetAttitude(Instigator, HitActor);
+		const ETeamAttitude::Type HitAttitude = TeamsComp->GetTeamAttitude(InstigatorTeamId, HitTeamId);
 		if (!FCommonTeamTypes::MatchesAttitudeMask(HitAttitude, AttitudeMask))
 		{
 			return true;
@@ -77,7 +118,7 @@ bool UTargetingFilterTask_TeamComparison::ShouldFilterTarget(const FTargetingReq
 
 	if (ComparisonMask != FCommonTeamTypes::AllComparisonsMask)
 	{
-		const ECommonTeamComparison HitComparison = TeamsComp->CompareTeams(Instigator, HitActor);
+		const ECommonTeamComparison HitComparison = UCommonTeamsComponent::CompareTeamIds(InstigatorTeamId, HitTeamId);
 		if (!FCommonTeamTypes::MatchesComparisonMask(HitComparison, ComparisonMask))
 		{
 			return true;
@@ -86,3 +127,21 @@ bool UTargetingFilterTask_TeamComparison::ShouldFilterTarget(const FTargetingReq
 
 	return false;
 }
+
+const UCommonTeamsComponent* UTargetingFilterTask_TeamComparison::FindTeamsComponent(const FTargetingSourceContext* SourceContext,
+                                                                                     const TArray<FTargetingDefaultResultData>& TargetResults)
+{
+	const UObject* WorldContextObject = nullptr;
+	if (SourceContext)
+	{
+		WorldContextObject = SourceContext->InstigatorActor ? SourceContext->InstigatorActor.Get() : SourceContext->SourceActor.Get();
+	}
+
+	// fallback to the first hit actor
+	for (int32 TargetIdx = 0; !WorldContextObject && TargetIdx < TargetResults.Num(); ++TargetIdx)
+	{
+		WorldContextObject = TargetResults[TargetIdx].HitResult.GetActor();
+	}
+
+	return WorldContextObject ? UCommonTeamStatics::GetTeamsComponent(WorldContextObject) : nullptr;
+}
@@ -36,9 +36,12 @@ bool UTeamComparisonGameplayEffectComponent::CanGameplayEffectApply(const FActiv
 		return false;
 	}
 
+	const FGenericTeamId InstigatorTeamId = TeamsComp->GetObjectGenericTeamId(Instigator);
+	const FGenericTeamId TargetTeamId = TeamsComp->GetObjectGenericTeamId(ActiveGEContainer.Owner->GetOwner());
+
 	if (AttitudeMask != FCommonTeamTypes::AllAttitudesMask)
 	{
-		const ETeamAttitude::Type Attitude = TeamsComp->GetAttitude(Instigator, ActiveGEContainer.Owner->GetOwner());
+		const ETeamAttitude::Type Attitude = TeamsComp->GetTeamAttitude(InstigatorTeamId, TargetTeamId);
 		if (!FCommonTeamTypes::MatchesAttitudeMask(Attitude, AttitudeMask))
 		{
 			return false;
@@ -47,7 +50,7 @@ bool UTeamComparisonGameplayEffectComponent::CanGameplayEffectApply(const FActiv
 
 	if (ComparisonMask != FCommonTeamTypes::AllComparisonsMask)
 	{
-		const ECommonTeamComparison Comparison = TeamsComp->CompareTeams(Instigator, ActiveGEContainer.Owner->GetOwner());
+		const ECommonTeamComparison Comparison = UCommonTeamsComponent::CompareTeamIds(InstigatorTeamId, TargetTeamId);
 		if (!FCommonTeamTypes::MatchesComparisonMask(Comparison, ComparisonMask))
 		{
 			return false;
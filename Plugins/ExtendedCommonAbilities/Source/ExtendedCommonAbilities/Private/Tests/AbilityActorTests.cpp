@@ -0,0 +1,88 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "AbilitiesInitStateComponent.h"
+#include "AbilityCharacter.h"
+#include "AbilityPawn.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "NativeGameplayTags.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+namespace AbilityActorTagQueryBenchmark
+{
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test, "ExtendedCommonAbilities.Test");
+
+	constexpr int32 NumQueries = 1000000;
+
+	/** Return the average nanoseconds per call of a function. */
+	template <typename FuncType>
+	double TimeQueries(FuncType&& Func, int32& OutNumMatches)
+	{
+		OutNumMatches = 0;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Idx = 0; Idx < NumQueries; ++Idx)
+		{
+			OutNumMatches += Func() ? 1 : 0;
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1e9 / NumQueries;
+	}
+
+	/**
+	 * Compare tag queries through the cached init state component to casting the init state component on every query.
+	 * The actors aren't initialized, so this measures the cost of reaching the ability system.
+	 */
+	template <typename ActorType>
+	void RunBenchmark(FAutomationTestBase& Test, const ActorType* Actor)
+	{
+		if (!Test.TestNotNull(TEXT("Actor"), Actor))
+		{
+			return;
+		}
+
+		const IGameplayTagAssetInterface* TagInterface = Actor;
+		const FGameplayTag Tag = TAG_Test;
+
+		int32 NumCachedMatches;
+		const double CachedNanoseconds = TimeQueries([TagInterface, Tag]()
+		{
+			return TagInterface->HasMatchingGameplayTag(Tag);
+		}, NumCachedMatches);
+
+		int32 NumCastMatches;
+		const double CastNanoseconds = TimeQueries([Actor, Tag]()
+		{
+			const UAbilitiesInitStateComponent* InitStateComp = Cast<UAbilitiesInitStateComponent>(Actor->GetInitStateComponent());
+			const UAbilitySystemComponent* AbilitySystem = InitStateComp ? InitStateComp->GetAbilitySystemComponent() : nullptr;
+			return AbilitySystem && AbilitySystem->HasMatchingGameplayTag(Tag);
+		}, NumCastMatches);
+
+		Test.TestEqual(FString::Printf(TEXT("%s cached and cast queries match"), *Actor->GetClass()->GetName()), NumCachedMatches, NumCastMatches);
+		Test.AddInfo(FString::Printf(TEXT("%s HasMatchingGameplayTag: cached %.2f ns, cast %.2f ns"),
+		                             *Actor->GetClass()->GetName(), CachedNanoseconds, CastNanoseconds));
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAbilityActorTagQueryBenchmark, "ExtendedCommonAbilities.AbilityActors.TagQuery.Benchmark",
+                                 EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FAbilityActorTagQueryBenchmark::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	AbilityActorTagQueryBenchmark::RunBenchmark(*this, World->SpawnActor<AAbilityCharacter>());
+	AbilityActorTagQueryBenchmark::RunBenchmark(*this, World->SpawnActor<AAbilityPawn>());
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif
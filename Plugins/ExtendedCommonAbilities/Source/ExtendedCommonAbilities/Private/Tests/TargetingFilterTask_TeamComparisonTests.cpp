@@ -0,0 +1,90 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+#include "Teams/CommonTeamsComponent.h"
+#include "Teams/TargetingFilterTask_TeamComparison.h"
+#include "TargetingSystem/TargetingSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTargetingFilterTeamComparisonBenchmark, "ExtendedCommonAbilities.Teams.TeamComparisonFilter.Benchmark",
+                                 EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FTargetingFilterTeamComparisonBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumTargets = 500;
+	constexpr int32 NumIterations = 200;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	AActor* TeamsOwner = World->SpawnActor<AActor>();
+	UCommonTeamsComponent* TeamsComp = NewObject<UCommonTeamsComponent>(TeamsOwner);
+	TeamsComp->RegisterComponent();
+
+	// an AoE hitting an even mix of two teams
+	AActor* Instigator = World->SpawnActor<AActor>();
+	TeamsComp->SetCachedTeamId(Instigator, FGenericTeamId(1));
+
+	TArray<FTargetingDefaultResultData> AllTargets;
+	AllTargets.SetNum(NumTargets);
+	for (int32 TargetIdx = 0; TargetIdx < NumTargets; ++TargetIdx)
+	{
+		AActor* Target = World->SpawnActor<AActor>();
+		TeamsComp->SetCachedTeamId(Target, FGenericTeamId(TargetIdx % 2 ? 1 : 2));
+		AllTargets[TargetIdx].HitResult.HitObjectHandle = FActorInstanceHandle(Target);
+	}
+
+	UTargetingFilterTask_TeamComparison* Task = NewObject<UTargetingFilterTask_TeamComparison>();
+	Task->AttitudeMask = static_cast<uint8>(1 << ETeamAttitude::Hostile);
+
+	FTargetingSourceContext SourceContext;
+	SourceContext.InstigatorActor = Instigator;
+	SourceContext.SourceActor = Instigator;
+	FTargetingRequestHandle TargetingHandle = UTargetingSubsystem::MakeTargetRequestHandle(nullptr, SourceContext);
+	TArray<FTargetingDefaultResultData>& TargetResults = FTargetingDefaultResultsSet::FindOrAdd(TargetingHandle).TargetResults;
+
+	// filter each target independently, resolving the instigator and teams for every target
+	double PerTargetSeconds = 0.0;
+	int32 NumKeptPerTarget = 0;
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		NumKeptPerTarget = 0;
+		for (const FTargetingDefaultResultData& TargetData : AllTargets)
+		{
+			NumKeptPerTarget += Task->ShouldFilterTarget(TargetingHandle, TargetData) ? 0 : 1;
+		}
+		PerTargetSeconds += FPlatformTime::Seconds() - StartTime;
+	}
+
+	// filter all targets with Execute, resolving the instigator and teams once
+	double ExecuteSeconds = 0.0;
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		TargetResults = AllTargets;
+
+		const double StartTime = FPlatformTime::Seconds();
+		Task->Execute(TargetingHandle);
+		ExecuteSeconds += FPlatformTime::Seconds() - StartTime;
+	}
+
+	TestEqual(TEXT("Execute keeps the same targets as ShouldFilterTarget"), TargetResults.Num(), NumKeptPerTarget);
+
+	AddInfo(FString::Printf(TEXT("Filtering %d targets: per target %.3f us, Execute %.3f us"),
+	                        NumTargets, PerTargetSeconds * 1e6 / NumIterations, ExecuteSeconds * 1e6 / NumIterations));
+
+	UTargetingSubsystem::ReleaseTargetRequestHandle(TargetingHandle);
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include "AbilityCharacter.generated.h"
 
 class UAbilitiesInitStateComponent;
+class UCommonHealthComponent;
 class UGameplayTagInputConfig;
 class UPawnAbilityInputComponent;
 
@@ -52,11 +53,23 @@ public:
 		return Cast<T>(GetAbilitySystemComponent());
 	}
 
-	UAbilitiesInitStateComponent* GetAbilitiesInitStateComponent() const;
+	/** Return the InitStateComponent as an AbilitiesInitStateComponent. */
+	UAbilitiesInitStateComponent* GetAbilitiesInitStateComponent() const { return AbilitiesInitStateComponent; }
+
+	/** Return the health component of this character, if it has one. */
+	UCommonHealthComponent* GetHealthComponent() const;
 
 	UPawnAbilityInputComponent* GetPawnAbilityInputComponent() const { return PawnAbilityInputComponent; }
 
 protected:
+	/** The InitStateComponent as an AbilitiesInitStateComponent, cached to avoid casting in hot accessors. */
+	UPROPERTY(Transient)
+	TObjectPtr<UAbilitiesInitStateComponent> AbilitiesInitStateComponent;
+
+	/** The health component found when components were initialized. */
+	UPROPERTY(Transient)
+	TObjectPtr<UCommonHealthComponent> HealthComponent;
+
 	virtual void OnInitializeAbilitySystem();
 	virtual void OnUninitializeAbilitySystem();
 
@@ -29,6 +29,10 @@ protected:
 public:
 	AAbilityPlayerState(const FObjectInitializer& ObjectInitializer);
 
+	virtual void PostInitializeComponents() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// IAbilitySystemInterface
 	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
 
@@ -61,4 +65,13 @@ protected:
 	virtual void OnRep_TeamId(FGenericTeamId OldTeamId);
 
 	virtual void BroadcastTeamChanged(const FGenericTeamId& NewTeamId, const FGenericTeamId& OldTeamId);
+
+	UFUNCTION()
+	virtual void OnPawnChanged(APlayerState* Player, APawn* NewPawn, APawn* OldPawn);
+
+	/** Update the team member counts and cached team ids of the teams component for this player and its pawn. */
+	void UpdateTeamsComponent(const APawn* OldPawn = nullptr);
+
+	/** Remove this player and its pawn from the teams component. */
+	void RemoveFromTeamsComponent();
 };
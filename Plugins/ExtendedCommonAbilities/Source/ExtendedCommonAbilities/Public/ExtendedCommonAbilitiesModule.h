@@ -4,9 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCommonAbilities, Log, All);
 
+DECLARE_STATS_GROUP(TEXT("ExtendedCommonAbilities"), STATGROUP_ExtendedCommonAbilities, STATCAT_Advanced);
+
 
 class FExtendedCommonAbilitiesModule : public IModuleInterface
 {
@@ -22,14 +22,14 @@ public:
 	/** The current HP of a character. */
 	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_HP, Category = "Health")
 	FGameplayAttributeData HP;
-	GAMEPLAYATTRIBUTE_ACCESSORS(UHPAttributeSet, HP)
+	EXTENDED_GAMEPLAYATTRIBUTE_ACCESSORS(UHPAttributeSet, HP)
 	UFUNCTION()
 	virtual void OnRep_HP(FGameplayAttributeData& OldValue);
 
 	/** The maximum HP of a character. */
 	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_MaxHP, Category = "Health")
 	FGameplayAttributeData MaxHP;
-	GAMEPLAYATTRIBUTE_ACCESSORS(UHPAttributeSet, MaxHP)
+	EXTENDED_GAMEPLAYATTRIBUTE_ACCESSORS(UHPAttributeSet, MaxHP)
 	UFUNCTION()
 	virtual void OnRep_MaxHP(FGameplayAttributeData& OldValue);
 
@@ -131,8 +131,5 @@ protected:
 public:
 	/** Return the CommonHealthComponent of an actor, if one exists. */
 	UFUNCTION(BlueprintPure, Category = "CommonAbilities|Health")
-	static UCommonHealthComponent* GetHealthComponent(const AActor* Actor)
-	{
-		return Actor ? Actor->FindComponentByClass<UCommonHealthComponent>() : nullptr;
-	}
+	static UCommonHealthComponent* GetHealthComponent(const AActor* Actor);
 };
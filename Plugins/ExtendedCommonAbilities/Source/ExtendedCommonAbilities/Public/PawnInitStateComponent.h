@@ -41,6 +41,13 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "InitState")
 	bool bWaitForInputComponent = true;
 
+	/**
+	 * Defer init state checks caused by controller, player state, input, or other feature changes until the end of the frame,
+	 * so that any number of changes in a frame only check the init state once. Useful for pawns that are spawned in large numbers.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "InitState")
+	bool bDeferInitStateChecks = false;
+
 	/** The name of this actor feature. */
 	static FName NAME_FeatureName;
 
@@ -56,18 +63,25 @@ public:
 	/** Return true if all data is initialized, allowing a transition to DataInitialized init state. */
 	virtual bool CheckDataInitialized(UGameFrameworkComponentManager* Manager) const;
 
+	/** Check the init state now, or at the end of the frame if bDeferInitStateChecks is enabled. */
+	void RequestInitStateCheck();
+
 	void NotifyControllerChanged();
 	void NotifyPlayerStateReplicated();
 	void NotifySetupPlayerInputComponent(UInputComponent* InputComponent);
 
+	/**
+	 * Called when a pawn's controller changes. Routed only for this component's pawn by the UPawnInitStateSubsystem,
+	 * or for any pawn in the game instance when the subsystem doesn't exist.
+	 */
+	UFUNCTION()
+	virtual void OnAnyPawnControllerChanged(APawn* Pawn, AController* Controller);
+
 protected:
 	virtual void OnRegister() override;
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-	UFUNCTION()
-	virtual void OnAnyPawnControllerChanged(APawn* Pawn, AController* Controller);
-
 public:
 	/** Return the pawn init state component from an actor. */
 	UFUNCTION(BlueprintPure, Category = "InitState|Pawn")
@@ -0,0 +1,75 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "PawnInitStateSubsystem.generated.h"
+
+class AController;
+class APawn;
+class UPawnInitStateComponent;
+
+
+/**
+ * Batches init state checks for pawn init state components that defer them.
+ * Any number of requests made for a component during a frame result in a single check at the end of the frame,
+ * which keeps large numbers of pawns spawned at once from repeatedly checking their init states.
+ *
+ * Also listens for pawn controller changes once for the whole world, and routes them
+ * only to the init state components of the pawn that changed.
+ */
+UCLASS()
+class EXTENDEDCOMMONABILITIES_API UPawnInitStateSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Notify a component whenever the controller of its pawn changes. */
+	void RegisterControllerChangeListener(UPawnInitStateComponent* Component);
+
+	/** Stop notifying a component of controller changes. */
+	void UnregisterControllerChangeListener(UPawnInitStateComponent* Component);
+
+	/** Request an init state check for a component at the end of the frame. */
+	void RequestInitStateCheck(UPawnInitStateComponent* Component);
+
+	/** Cancel a pending init state check for a component, e.g. when it ends play. */
+	void CancelInitStateCheck(UPawnInitStateComponent* Component);
+
+	/** Return the total number of requested init state checks that were skipped because one was already pending. */
+	int64 GetNumSkippedInitStateChecks() const { return NumSkippedInitStateChecks; }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableWhenPaused() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Components to notify of controller changes, by their pawn. */
+	TMap<TObjectKey<APawn>, TArray<TWeakObjectPtr<UPawnInitStateComponent>, TInlineAllocator<1>>> ControllerChangeListeners;
+
+	/** The total number of components in ControllerChangeListeners. */
+	int32 NumControllerChangeListeners = 0;
+
+	/** True once bound to the game instance's pawn controller changed event. */
+	bool bIsBoundToPawnControllerChanged = false;
+
+	UFUNCTION()
+	void OnPawnControllerChanged(APawn* Pawn, AController* Controller);
+
+	/** Components waiting for an init state check. */
+	TSet<TWeakObjectPtr<UPawnInitStateComponent>> PendingComponents;
+
+	/** The total number of requested init state checks that were skipped because one was already pending. */
+	int64 NumSkippedInitStateChecks = 0;
+
+	/** Check init states of all pending components, including any that are requested while processing. */
+	void ProcessPendingComponents();
+};
@@ -6,6 +6,8 @@
 #include "Engine/DataAsset.h"
 #include "CommonTeamDef.generated.h"
 
+class UCommonTeamRelationships;
+
 
 /**
  * The definition for a team and any displayable properties for it.
@@ -20,4 +22,8 @@ public:
 	/** The display name of the team */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FText DisplayName;
+
+	/** The attitude of this team towards other teams. If not set, the global team attitude solver is used. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TObjectPtr<const UCommonTeamRelationships> Relationships;
 };
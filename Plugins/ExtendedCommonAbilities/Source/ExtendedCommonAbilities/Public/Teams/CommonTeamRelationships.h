@@ -0,0 +1,35 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GenericTeamAgentInterface.h"
+#include "Engine/DataAsset.h"
+#include "CommonTeamRelationships.generated.h"
+
+
+/**
+ * Defines the attitude of a team towards other teams, allowing alliances and neutral factions.
+ * Assigned to a team using UCommonTeamDef::Relationships.
+ */
+UCLASS(BlueprintType)
+class EXTENDEDCOMMONABILITIES_API UCommonTeamRelationships : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** The attitude of the team towards its own members. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Teams")
+	TEnumAsByte<ETeamAttitude::Type> SelfAttitude = ETeamAttitude::Friendly;
+
+	/** The attitude of the team towards any team that isn't in TeamAttitudes. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Teams")
+	TEnumAsByte<ETeamAttitude::Type> DefaultAttitude = ETeamAttitude::Hostile;
+
+	/** The attitude of the team towards other specific teams, by team id. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Teams")
+	TMap<uint8, TEnumAsByte<ETeamAttitude::Type>> TeamAttitudes;
+
+	/** Return the attitude of the team with id OwnTeamId towards another team. */
+	ETeamAttitude::Type GetAttitudeTowards(uint8 OwnTeamId, uint8 OtherTeamId) const;
+};
@@ -20,7 +20,7 @@ class EXTENDEDCOMMONABILITIES_API UCommonTeamStatics : public UBlueprintFunction
 	GENERATED_BODY()
 
 public:
-	/** Return the teams component from the game state. */
+	/** Return the teams component from the game state, as registered with the UCommonTeamsSubsystem. */
 	UFUNCTION(BlueprintPure, Category = "Teams", meta = (WorldContext = "WorldContextObject"))
 	static UCommonTeamsComponent* GetTeamsComponent(const UObject* WorldContextObject);
 
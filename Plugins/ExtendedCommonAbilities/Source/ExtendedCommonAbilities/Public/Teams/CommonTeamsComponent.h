@@ -29,17 +29,47 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Teams")
 	const UCommonTeamDef* GetTeamDefinition(int32 TeamId) const;
 
+	/** Set or clear the definition for a team, and update team attitudes. */
+	UFUNCTION(BlueprintCallable, Category = "Teams")
+	void SetTeamDefinition(int32 TeamId, const UCommonTeamDef* TeamDef);
+
+	/**
+	 * Rebuild the attitudes between all teams the next time they are used. Must be called if TeamDefinitions
+	 * or their relationships are changed directly, or if the attitude solver is changed after BeginPlay.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Teams")
+	void RebuildTeamAttitudes();
+
 	/** Return the team with the least number of players. */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "Teams")
 	int32 GetLeastPopulatedTeam() const;
 
+	/** Return the number of active players on a team. */
+	UFUNCTION(BlueprintPure, Category = "Teams")
+	int32 GetTeamMemberCount(int32 TeamId) const;
+
+	/** Update the team member counts for a player, after it has changed teams or become inactive. */
+	void UpdatePlayerTeamCount(const APlayerState* PlayerState);
+
+	/** Remove a player from the team member counts, e.g. when it logs out. */
+	void RemovePlayerTeamCount(const APlayerState* PlayerState);
+
 	/** Find and return the team agent interface to use for an object. */
 	virtual IGenericTeamAgentInterface* GetTeamInterfaceForObject(UObject* Object) const;
 	virtual const IGenericTeamAgentInterface* GetTeamInterfaceForObject(const UObject* Object) const;
 
-	/** Return the generic team id for an actor or object. */
+	/** Return the generic team id for an actor or object. Uses the cached team id if one exists. */
 	virtual FGenericTeamId GetObjectGenericTeamId(const UObject* Object) const;
 
+	/**
+	 * Set the cached team id for an object, so it can be found without resolving its team interface.
+	 * Only objects that report every team change should be cached, see AAbilityPlayerState.
+	 */
+	void SetCachedTeamId(const UObject* Object, const FGenericTeamId& TeamId);
+
+	/** Remove the cached team id for an object. */
+	void RemoveCachedTeamId(const UObject* Object);
+
 	/** Return the team id for an actor or object. */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "Teams", meta = (DefaultToSelf = "Object"))
 	virtual int32 GetObjectTeam(const UObject* Object) const;
@@ -59,6 +89,47 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "Teams", meta = (DefaultToSelf = "ObjectA"))
 	ECommonTeamComparison CompareTeams(const UObject* ObjectA, const UObject* ObjectB) const;
 
+	/** Return the attitude of team A towards team B. */
+	FORCEINLINE ETeamAttitude::Type GetTeamAttitude(const FGenericTeamId& TeamIdA, const FGenericTeamId& TeamIdB) const
+	{
+		UpdateTeamAttitudesIfDirty();
+		return static_cast<ETeamAttitude::Type>(TeamAttitudes[GetTeamPairIndex(TeamIdA, TeamIdB)]);
+	}
+
+	/** Return the index of a pair of teams in the TeamAttitudes table. */
+	FORCEINLINE static int32 GetTeamPairIndex(const FGenericTeamId& TeamIdA, const FGenericTeamId& TeamIdB)
+	{
+		return (static_cast<int32>(TeamIdA.GetId()) << 8) | TeamIdB.GetId();
+	}
+
+	/** Compare two team ids. */
+	static ECommonTeamComparison CompareTeamIds(const FGenericTeamId& TeamIdA, const FGenericTeamId& TeamIdB);
+
+	/** Gather the team id of each object, using cached team ids where possible. */
+	template <typename AllocatorType>
+	void GetObjectTeamIds(const TArray<AActor*>& Objects, TArray<uint8, AllocatorType>& OutTeamIds) const
+	{
+		OutTeamIds.SetNumUninitialized(Objects.Num());
+		for (int32 Idx = 0; Idx < Objects.Num(); ++Idx)
+		{
+			OutTeamIds[Idx] = GetObjectGenericTeamId(Objects[Idx]).GetId();
+		}
+	}
+
+	/** Return the attitude of an observer towards, and the team comparison with, each of a list of targets. */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "Teams", meta = (DefaultToSelf = "Observer"))
+	void CompareTeamsBatch(const UObject* Observer, const TArray<AActor*>& Targets,
+	                       TArray<TEnumAsByte<ETeamAttitude::Type>>& OutAttitudes, TArray<ECommonTeamComparison>& OutComparisons) const;
+
+	/** Return the indices of the targets that match both the attitude and comparison masks, relative to an observer. */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "Teams", meta = (DefaultToSelf = "Observer"))
+	void FilterTeamsBatch(const UObject* Observer, const TArray<AActor*>& Targets,
+	                      UPARAM(meta = (Bitmask, BitmaskEnum = "/Script/AIModule.ETeamAttitude")) int32 AttitudeMask,
+	                      UPARAM(meta = (Bitmask, BitmaskEnum = "/Script/ExtendedCommonAbilities.ECommonTeamComparison")) int32 ComparisonMask,
+	                      TArray<int32>& OutIndices) const;
+
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
@@ -70,6 +141,13 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Teams")
 	virtual void AssignTeamForPlayer(APlayerState* PlayerState);
 
+	/**
+	 * Reassign all players to teams so that each team has an even number of players.
+	 * Spectators are assigned no team. Does not use SelectTeamForPlayer.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Teams")
+	virtual void BalanceTeamsForPlayers();
+
 protected:
 	/** Called during BeginPlay to start setting up teams. */
 	virtual void StartTeamSetup();
@@ -80,4 +158,53 @@ protected:
 
 	/** Called when a player logs in. */
 	virtual void OnPlayerPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer);
+
+	/** Called when a player logs out. */
+	virtual void OnPlayerLogout(AGameModeBase* GameMode, AController* Exiting);
+
+	/** Recount the members of each team from all player states. */
+	void RebuildTeamMemberCounts();
+
+	/** Compute the attitude of team A towards team B, used to build the TeamAttitudes table. */
+	virtual ETeamAttitude::Type ComputeTeamAttitude(const FGenericTeamId& TeamIdA, const FGenericTeamId& TeamIdB) const;
+
+	/** Recompute the attitudes of a team towards all teams, and of all teams towards it, the next time they are used. */
+	void MarkTeamAttitudesDirty(uint8 TeamId);
+
+	FORCEINLINE void UpdateTeamAttitudesIfDirty() const
+	{
+		if (bHasDirtyTeamAttitudes)
+		{
+			UpdateDirtyTeamAttitudes();
+		}
+	}
+
+	/** Recompute all dirty entries of the TeamAttitudes table. */
+	void UpdateDirtyTeamAttitudes() const;
+
+	/** The attitude of every team towards every other team, indexed by GetTeamPairIndex. Built on first use. */
+	mutable TArray<uint8> TeamAttitudes;
+
+	/** Teams whose row and column in TeamAttitudes must be recomputed. */
+	mutable TBitArray<> DirtyAttitudeTeams;
+
+	/** True when all of TeamAttitudes must be recomputed. */
+	mutable bool bAllTeamAttitudesDirty = true;
+
+	/** True when any of TeamAttitudes must be recomputed. */
+	mutable bool bHasDirtyTeamAttitudes = true;
+
+#if WITH_EDITOR
+	/** Rebuild team attitudes when a team definition or relationships asset is edited. */
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+#endif
+
+	/** The number of active players on each team, indexed by team id. */
+	TArray<int32> TeamMemberCounts;
+
+	/** The team that each player was counted for in TeamMemberCounts. */
+	TMap<TObjectKey<APlayerState>, uint8> CountedPlayerTeams;
+
+	/** Team ids for objects whose team changes are reported, to avoid resolving team interfaces for them. */
+	TMap<TObjectKey<UObject>, uint8> CachedTeamIds;
 };
@@ -0,0 +1,34 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CommonTeamsSubsystem.generated.h"
+
+class UCommonTeamsComponent;
+
+
+/**
+ * Keeps track of the teams component for a world, so it can be
+ * retrieved without searching the game state's components.
+ */
+UCLASS()
+class EXTENDEDCOMMONABILITIES_API UCommonTeamsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Return the teams component registered for this world. */
+	FORCEINLINE UCommonTeamsComponent* GetTeamsComponent() const { return TeamsComponent.Get(); }
+
+	/** Register the teams component for this world. Called automatically by the component. */
+	void RegisterTeamsComponent(UCommonTeamsComponent* InTeamsComponent);
+
+	/** Unregister the teams component, if it is the one currently registered. */
+	void UnregisterTeamsComponent(UCommonTeamsComponent* InTeamsComponent);
+
+protected:
+	UPROPERTY(Transient)
+	TObjectPtr<UCommonTeamsComponent> TeamsComponent;
+};
@@ -7,6 +7,8 @@
 #include "Tasks/TargetingFilterTask_BasicFilterTemplate.h"
 #include "TargetingFilterTask_TeamComparison.generated.h"
 
+class UCommonTeamsComponent;
+
 
 /**
  * Filter target data based on a team comparison.
@@ -32,5 +34,27 @@ public:
 	uint8 ComparisonMask;
 
 	virtual void Execute(const FTargetingRequestHandle& TargetingHandle) const override;
+
 	virtual bool ShouldFilterTarget(const FTargetingRequestHandle& TargetingHandle, const FTargetingDefaultResultData& TargetData) const override;
+
+protected:
+	/** The instigator and their team, which are the same for all targets of a request. */
+	struct FTeamFilterContext
+	{
+		FTargetingRequestHandle TargetingHandle;
+		const UCommonTeamsComponent* TeamsComp = nullptr;
+		const AActor* Instigator = nullptr;
+		FGenericTeamId InstigatorTeamId = FGenericTeamId::NoTeam;
+	};
+
+	/** The context of the request being executed, so that ShouldFilterTarget doesn't resolve it again for every target. */
+	mutable FTeamFilterContext ExecutingContext;
+
+	/** Return true if a hit actor should be filtered, given the instigator and their team. */
+	bool ShouldFilterHitActor(const UCommonTeamsComponent* TeamsComp, const AActor* Instigator, const FGenericTeamId& InstigatorTeamId,
+	                          const AActor* HitActor) const;
+
+	/** Return the teams component to use for a targeting request. */
+	static const UCommonTeamsComponent* FindTeamsComponent(const FTargetingSourceContext* SourceContext,
+	                                                       const TArray<FTargetingDefaultResultData>& TargetResults);
 };
@@ -0,0 +1,366 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "AI/BTAbilityTaskSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "ExtendedGameplayAbilitiesModule.h"
+#include "ExtendedGameplayAbilitiesSettings.h"
+#include "AI/BTTask_ActivateAbility.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/StableSort.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("Process Queued Ability Activations"), STAT_BTAbilityTaskSubsystem_ProcessQueue, STATGROUP_ExtendedGameplayAbilities);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Queued Ability Activations"), STAT_QueuedAbilityActivations, STATGROUP_ExtendedGameplayAbilities);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queued Ability Activations Processed"), STAT_QueuedAbilityActivationsProcessed, STATGROUP_ExtendedGameplayAbilities);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Max Ability Activation Latency (ms)"), STAT_MaxAbilityActivationLatency, STATGROUP_ExtendedGameplayAbilities);
+
+
+void UBTAbilityTaskSubsystem::Deinitialize()
+{
+	for (const auto& Elem : WaitingTasks)
+	{
+		if (UAbilitySystemComponent* AbilitySystem = Elem.Value.AbilitySystem.Get())
+		{
+			AbilitySystem->OnAbilityEnded.Remove(Elem.Value.OnAbilityEndedHandle);
+		}
+	}
+	WaitingTasks.Reset();
+
+	QueuedActivations.Reset();
+	SET_DWORD_STAT(STAT_QueuedAbilityActivations, 0);
+
+	Super::Deinitialize();
+}
+
+bool UBTAbilityTaskSubsystem::ShouldQueueAbilityActivations() const
+{
+	return GetDefault<UExtendedGameplayAbilitiesSettings>()->AIAbilityActivationsPerFrame > 0;
+}
+
+void UBTAbilityTaskSubsystem::QueueAbilityActivation(UAbilitySystemComponent* AbilitySystem, FGameplayAbilitySpecHandle SpecHandle,
+                                                     UBehaviorTreeComponent& OwnerComp, const UBTTask_ActivateAbility* Task)
+{
+	check(AbilitySystem);
+	check(Task);
+
+	FQueuedActivation& Activation = QueuedActivations.AddDefaulted_GetRef();
+	Activation.RequestId = ++LastActivationRequestId;
+	Activation.SpecHandle = SpecHandle;
+	Activation.AbilitySystem = AbilitySystem;
+	Activation.OwnerComp = &OwnerComp;
+	Activation.Task = Task;
+	Activation.QueueTime = FPlatformTime::Seconds();
+
+	SET_DWORD_STAT(STAT_QueuedAbilityActivations, QueuedActivations.Num());
+}
+
+void UBTAbilityTaskSubsystem::CancelQueuedAbilityActivation(const UBehaviorTreeComponent& OwnerComp, const UBTTask_ActivateAbility* Task)
+{
+	// keep the queue order, it's used for fairness between requests with the same priority
+	QueuedActivations.RemoveAll([&OwnerComp, Task](const FQueuedActivation& Activation)
+	{
+		return Activation.Task == Task && Activation.OwnerComp == &OwnerComp;
+	});
+
+	SET_DWORD_STAT(STAT_QueuedAbilityActivations, QueuedActivations.Num());
+}
+
+bool UBTAbilityTaskSubsystem::IsAbilityActivationQueued(const UBehaviorTreeComponent& OwnerComp, const UBTTask_ActivateAbility* Task) const
+{
+	return QueuedActivations.ContainsByPredicate([&OwnerComp, Task](const FQueuedActivation& Activation)
+	{
+		return Activation.Task == Task && Activation.OwnerComp == &OwnerComp;
+	});
+}
+
+void UBTAbilityTaskSubsystem::ResetActivationQueueMetrics()
+{
+	ActivationQueueMetrics = FBTAbilityActivationQueueMetrics();
+}
+
+void UBTAbilityTaskSubsystem::AddWaitingTask(UAbilitySystemComponent* AbilitySystem, FGameplayAbilitySpecHandle SpecHandle,
+                                             UBehaviorTreeComponent& OwnerComp, const UBTTask_ActivateAbility* Task)
+{
+	check(AbilitySystem);
+	check(Task);
+
+	const TObjectKey<UAbilitySystemComponent> AbilitySystemKey(AbilitySystem);
+	FAbilitySystemWaitingTasks& AbilitySystemTasks = WaitingTasks.FindOrAdd(AbilitySystemKey);
+
+	// bind once per ability system, regardless of how many tasks are waiting on it
+	if (!AbilitySystemTasks.OnAbilityEndedHandle.IsValid())
+	{
+		AbilitySystemTasks.AbilitySystem = AbilitySystem;
+		AbilitySystemTasks.OnAbilityEndedHandle = AbilitySystem->OnAbilityEnded.AddUObject(this, &ThisClass::OnAbilityEnded, AbilitySystemKey);
+	}
+
+	AbilitySystemTasks.Tasks.Add({SpecHandle, &OwnerComp, Task});
+}
+
+void UBTAbilityTaskSubsystem::RemoveWaitingTask(TObjectKey<UAbilitySystemComponent> AbilitySystemKey, const UBehaviorTreeComponent& OwnerComp,
+                                                const UBTTask_ActivateAbility* Task)
+{
+	FAbilitySystemWaitingTasks* AbilitySystemTasks = WaitingTasks.Find(AbilitySystemKey);
+	if (!AbilitySystemTasks)
+	{
+		return;
+	}
+
+	AbilitySystemTasks->Tasks.RemoveAllSwap([&OwnerComp, Task](const FWaitingTask& WaitingTask)
+	{
+		return WaitingTask.Task == Task && WaitingTask.OwnerComp == &OwnerComp;
+	});
+
+	UnbindIfNoWaitingTasks(AbilitySystemKey);
+}
+
+void UBTAbilityTaskSubsystem::OnAbilityEnded(const FAbilityEndedData& AbilityEndedData, TObjectKey<UAbilitySystemComponent> AbilitySystemKey)
+{
+	const FAbilitySystemWaitingTasks* AbilitySystemTasks = WaitingTasks.Find(AbilitySystemKey);
+	if (!AbilitySystemTasks)
+	{
+		return;
+	}
+
+	// gather first, since finishing a task removes it
+	TArray<FWaitingTask, TInlineAllocator<4>> EndedTasks;
+	for (const FWaitingTask& WaitingTask : AbilitySystemTasks->Tasks)
+	{
+		if (WaitingTask.SpecHandle == AbilityEndedData.AbilitySpecHandle)
+		{
+			EndedTasks.Add(WaitingTask);
+		}
+	}
+
+	for (const FWaitingTask& EndedTask : EndedTasks)
+	{
+		UBehaviorTreeComponent* OwnerComp = EndedTask.OwnerComp.Get();
+		const UBTTask_ActivateAbility* Task = EndedTask.Task.Get();
+		if (IsValid(OwnerComp) && Task)
+		{
+			Task->OnAbilityEnded(AbilityEndedData, *OwnerComp);
+		}
+	}
+
+	// remove any tasks whose behavior tree was destroyed without finishing them
+	if (FAbilitySystemWaitingTasks* RemainingTasks = WaitingTasks.Find(AbilitySystemKey))
+	{
+		RemainingTasks->Tasks.RemoveAllSwap([](const FWaitingTask& WaitingTask)
+		{
+			return !WaitingTask.OwnerComp.IsValid() || !WaitingTask.Task.IsValid();
+		});
+
+		UnbindIfNoWaitingTasks(AbilitySystemKey);
+	}
+}
+
+void UBTAbilityTaskSubsystem::UnbindIfNoWaitingTasks(TObjectKey<UAbilitySystemComponent> AbilitySystemKey)
+{
+	const FAbilitySystemWaitingTasks* AbilitySystemTasks = WaitingTasks.Find(AbilitySystemKey);
+	if (AbilitySystemTasks && AbilitySystemTasks->Tasks.IsEmpty())
+	{
+		if (UAbilitySystemComponent* AbilitySystem = AbilitySystemTasks->AbilitySystem.Get())
+		{
+			AbilitySystem->OnAbilityEnded.Remove(AbilitySystemTasks->OnAbilityEndedHandle);
+		}
+		WaitingTasks.Remove(AbilitySystemKey);
+	}
+}
+
+void UBTAbilityTaskSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ProcessQueuedActivations();
+}
+
+bool UBTAbilityTaskSubsystem::IsTickable() const
+{
+	return !QueuedActivations.IsEmpty();
+}
+
+ETickableTickType UBTAbilityTaskSubsystem::GetTickableTickType() const
+{
+	// don't tick the CDO
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UBTAbilityTaskSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBTAbilityTaskSubsystem, STATGROUP_Tickables);
+}
+
+void UBTAbilityTaskSubsystem::ProcessQueuedActivations()
+{
+	SCOPE_CYCLE_COUNTER(STAT_BTAbilityTaskSubsystem_ProcessQueue);
+
+	// activate everything if the limit was removed
+	const int32 MaxActivations = ShouldQueueAbilityActivations()
+		                             ? GetDefault<UExtendedGameplayAbilitiesSettings>()->AIAbilityActivationsPerFrame
+		                             : QueuedActivations.Num();
+
+	// remove requests whose behavior tree was destroyed without finishing them, so they don't use up the limit
+	QueuedActivations.RemoveAll([](const FQueuedActivation& Activation)
+	{
+		return !Activation.OwnerComp.IsValid() || !Activation.Task.IsValid();
+	});
+
+	// select requests first, since activating abilities can queue or cancel other requests.
+	// requests for destroyed ability systems just fail their task, so don't count against the limit
+	TArray<uint32, TInlineAllocator<16>> SelectedRequestIds;
+	for (const FQueuedActivation& Activation : QueuedActivations)
+	{
+		if (!Activation.AbilitySystem.IsValid())
+		{
+			SelectedRequestIds.Add(Activation.RequestId);
+		}
+	}
+	const int32 MaxSelected = SelectedRequestIds.Num() + MaxActivations;
+
+	TArray<int32> Order;
+	GetQueuedActivationOrder(Order);
+
+	TArray<TObjectKey<UAbilitySystemComponent>, TInlineAllocator<16>> SelectedAbilitySystems;
+	for (const int32 Idx : Order)
+	{
+		if (SelectedRequestIds.Num() >= MaxSelected)
+		{
+			break;
+		}
+
+		// activate at most one ability per ability system each frame, so that no single AI uses up the limit
+		const FQueuedActivation& Activation = QueuedActivations[Idx];
+		const TObjectKey<UAbilitySystemComponent> AbilitySystemKey(Activation.AbilitySystem.Get());
+		if (Activation.AbilitySystem.IsValid() && !SelectedAbilitySystems.Contains(AbilitySystemKey))
+		{
+			SelectedAbilitySystems.Add(AbilitySystemKey);
+			SelectedRequestIds.Add(Activation.RequestId);
+		}
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	double MaxFrameLatency = 0.0;
+
+	for (const uint32 RequestId : SelectedRequestIds)
+	{
+		const int32 Idx = Algo::BinarySearchBy(QueuedActivations, RequestId, &FQueuedActivation::RequestId);
+		if (Idx == INDEX_NONE)
+		{
+			// canceled by a previous activation
+			continue;
+		}
+
+		// clear the task so the request is no longer considered queued, and is removed with the others below
+		const FQueuedActivation Activation = QueuedActivations[Idx];
+		QueuedActivations[Idx].Task.Reset();
+
+		UAbilitySystemComponent* AbilitySystem = Activation.AbilitySystem.Get();
+		UBehaviorTreeComponent* OwnerComp = Activation.OwnerComp.Get();
+		const UBTTask_ActivateAbility* Task = Activation.Task.Get();
+		if (!IsValid(OwnerComp) || !Task)
+		{
+			continue;
+		}
+
+		const double Latency = Now - Activation.QueueTime;
+		MaxFrameLatency = FMath::Max(MaxFrameLatency, Latency);
+		++ActivationQueueMetrics.NumActivations;
+		ActivationQueueMetrics.TotalLatency += Latency;
+		ActivationQueueMetrics.MaxLatency = FMath::Max(ActivationQueueMetrics.MaxLatency, Latency);
+		ActivationQueueMetrics.MaxFramesQueued = FMath::Max(ActivationQueueMetrics.MaxFramesQueued, Activation.NumFramesQueued);
+		INC_DWORD_STAT(STAT_QueuedAbilityActivationsProcessed);
+
+		Task->ActivateQueuedAbility(*OwnerComp, AbilitySystem, Activation.SpecHandle);
+	}
+
+	// remove processed requests, and any whose behavior tree was destroyed while activating
+	QueuedActivations.RemoveAll([](const FQueuedActivation& Activation)
+	{
+		return !Activation.OwnerComp.IsValid() || !Activation.Task.IsValid();
+	});
+
+	for (FQueuedActivation& Activation : QueuedActivations)
+	{
+		++Activation.NumFramesQueued;
+	}
+
+	SET_FLOAT_STAT(STAT_MaxAbilityActivationLatency, MaxFrameLatency * 1000.0);
+	SET_DWORD_STAT(STAT_QueuedAbilityActivations, QueuedActivations.Num());
+}
+
+void UBTAbilityTaskSubsystem::GetQueuedActivationOrder(TArray<int32>& OutOrder) const
+{
+	OutOrder.Reset(QueuedActivations.Num());
+	for (int32 Idx = 0; Idx < QueuedActivations.Num(); ++Idx)
+	{
+		OutOrder.Add(Idx);
+	}
+
+	if (!GetDefault<UExtendedGameplayAbilitiesSettings>()->bPrioritizeAIAbilityActivationsByDistance)
+	{
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	if (ViewLocations.IsEmpty())
+	{
+		return;
+	}
+
+	// distances to the closest player, or negative for requests without an avatar
+	TArray<double> Priorities;
+	Priorities.SetNumUninitialized(QueuedActivations.Num());
+	double TotalDistSquared = 0.0;
+	int32 NumWithAvatar = 0;
+	for (int32 Idx = 0; Idx < QueuedActivations.Num(); ++Idx)
+	{
+		const UAbilitySystemComponent* AbilitySystem = QueuedActivations[Idx].AbilitySystem.Get();
+		const AActor* Avatar = AbilitySystem ? AbilitySystem->GetAvatarActor_Direct() : nullptr;
+		if (!Avatar)
+		{
+			Priorities[Idx] = -1.0;
+			continue;
+		}
+
+		const FVector AvatarLocation = Avatar->GetActorLocation();
+		double MinDistSquared = TNumericLimits<double>::Max();
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			MinDistSquared = FMath::Min(MinDistSquared, FVector::DistSquared(AvatarLocation, ViewLocation));
+		}
+
+		Priorities[Idx] = MinDistSquared;
+		TotalDistSquared += MinDistSquared;
+		++NumWithAvatar;
+	}
+
+	// requests without an avatar have no known distance, so neither jump nor trail the queue
+	const double NeutralDistSquared = NumWithAvatar > 0 ? TotalDistSquared / NumWithAvatar : 0.0;
+
+	for (int32 Idx = 0; Idx < QueuedActivations.Num(); ++Idx)
+	{
+		const double DistSquared = Priorities[Idx] >= 0.0 ? Priorities[Idx] : NeutralDistSquared;
+
+		// lower is more important, and waiting brings requests closer so they can't be starved
+		Priorities[Idx] = DistSquared / FMath::Square(1.0 + QueuedActivations[Idx].NumFramesQueued);
+	}
+
+	// stable, so requests with the same priority are processed in the order they were queued
+	Algo::StableSortBy(OutOrder, [&Priorities](const int32 Idx) { return Priorities[Idx]; });
+}
@@ -5,6 +5,10 @@
 
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemLog.h"
+#include "ExtendedAbilitySystemComponent.h"
+#include "Abilities/GameplayAbility.h"
+#include "AI/BTAbilityTaskSubsystem.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
 
 UBTTask_ActivateAbility::UBTTask_ActivateAbility(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer),
@@ -13,8 +17,7 @@ UBTTask_ActivateAbility::UBTTask_ActivateAbility(const FObjectInitializer& Objec
 	  bFailOnAbilityCancel(true)
 {
 	NodeName = "ActivateAbility";
-	// required for ability end events to be bound
-	bCreateNodeInstance = true;
+	bNotifyTaskFinished = true;
 }
 
 EBTNodeResult::Type UBTTask_ActivateAbility::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
@@ -38,43 +41,39 @@ EBTNodeResult::Type UBTTask_ActivateAbility::ExecuteTask(UBehaviorTreeComponent&
 		return EBTNodeResult::Failed;
 	}
 
-	// cancel the ability if requested
-	if (bRestartAbility && AbilitySpec->IsActive())
-	{
-		AbilitySystem->CancelAbilityHandle(AbilitySpec->Handle);
-	}
-
-	// bind events before activation, in case it ends immediately
-	if (bWaitForAbilityEnd)
-	{
-		// TODO: use bt node memory
-		SpecHandle = AbilitySpec->Handle;
-		AbilitySystemPtr = AbilitySystem;
-		AbilitySystem->OnAbilityEnded.AddUObject(this, &ThisClass::OnAbilityEnded, &OwnerComp);
-	}
-
-	const bool bSuccess = AbilitySystem->TryActivateAbility(AbilitySpec->Handle, true);
-	if (!bSuccess)
-	{
-		UE_VLOG(OwnerComp.GetOwner(), LogAbilitySystem, Error, TEXT("Failed to activate ability: %s"), *AbilitySpec->GetDebugString());
-		return EBTNodeResult::Failed;
-	}
+	FBTActivateAbilityTaskMemory* MyMemory = CastInstanceNodeMemory<FBTActivateAbilityTaskMemory>(NodeMemory);
+	MyMemory->SpecHandle = AbilitySpec->Handle;
+	MyMemory->AbilitySystem = AbilitySystem;
+	MyMemory->AbilitySystemKey = TObjectKey<UAbilitySystemComponent>(AbilitySystem);
 
-	if (bWaitForAbilityEnd)
+	// spread activations across frames when many AI activate abilities at once
+	UBTAbilityTaskSubsystem* AbilityTaskSubsystem = UWorld::GetSubsystem<UBTAbilityTaskSubsystem>(OwnerComp.GetWorld());
+	if (AbilityTaskSubsystem && AbilityTaskSubsystem->ShouldQueueAbilityActivations())
 	{
+		AbilityTaskSubsystem->QueueAbilityActivation(AbilitySystem, AbilitySpec->Handle, OwnerComp, this);
 		return EBTNodeResult::InProgress;
 	}
 
-	// TODO: what if it was activated then immediately canceled? this should respect bFailOnAbilityCancel
-	// ability was activated, that's all that matters
-	return EBTNodeResult::Succeeded;
+	return ActivateAbility(OwnerComp, *AbilitySystem, AbilitySpec->Handle);
 }
 
 EBTNodeResult::Type UBTTask_ActivateAbility::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
 {
-	if (bWaitForAbilityEnd && SpecHandle.IsValid() && AbilitySystemPtr.IsValid())
+	FBTActivateAbilityTaskMemory* MyMemory = CastInstanceNodeMemory<FBTActivateAbilityTaskMemory>(NodeMemory);
+
+	const FGameplayAbilitySpecHandle AbilitySpecHandle = MyMemory->SpecHandle;
+	UAbilitySystemComponent* AbilitySystem = MyMemory->AbilitySystem.Get();
+
+	// don't cancel the ability if this task never activated it
+	const UBTAbilityTaskSubsystem* AbilityTaskSubsystem = UWorld::GetSubsystem<UBTAbilityTaskSubsystem>(OwnerComp.GetWorld());
+	const bool bWasActivated = !AbilityTaskSubsystem || !AbilityTaskSubsystem->IsAbilityActivationQueued(OwnerComp, this);
+
+	// stop waiting first, so that canceling doesn't also try to finish this task
+	StopWaitingForAbility(OwnerComp, *MyMemory);
+
+	if (bWaitForAbilityEnd && bWasActivated && AbilitySpecHandle.IsValid() && AbilitySystem)
 	{
-		AbilitySystemPtr->CancelAbilityHandle(SpecHandle);
+		AbilitySystem->CancelAbilityHandle(AbilitySpecHandle);
 	}
 
 	return EBTNodeResult::Aborted;
@@ -82,8 +81,24 @@ EBTNodeResult::Type UBTTask_ActivateAbility::AbortTask(UBehaviorTreeComponent& O
 
 void UBTTask_ActivateAbility::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult)
 {
-	SpecHandle = FGameplayAbilitySpecHandle();
-	AbilitySystemPtr.Reset();
+	StopWaitingForAbility(OwnerComp, *CastInstanceNodeMemory<FBTActivateAbilityTaskMemory>(NodeMemory));
+
+	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
+}
+
+uint16 UBTTask_ActivateAbility::GetInstanceMemorySize() const
+{
+	return sizeof(FBTActivateAbilityTaskMemory);
+}
+
+void UBTTask_ActivateAbility::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTActivateAbilityTaskMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_ActivateAbility::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTActivateAbilityTaskMemory>(NodeMemory, CleanupType);
 }
 
 FString UBTTask_ActivateAbility::GetStaticDescription() const
@@ -97,27 +112,103 @@ FString UBTTask_ActivateAbility::GetStaticDescription() const
 	                       *Super::GetStaticDescription(), *AbilityDesc, *BlackboardKey.SelectedKeyName.ToString(), *ResultDesc);
 }
 
-void UBTTask_ActivateAbility::OnAbilityEnded(const FAbilityEndedData& AbilityEndedData, UBehaviorTreeComponent* OwnerComp)
+void UBTTask_ActivateAbility::OnAbilityEnded(const FAbilityEndedData& AbilityEndedData, UBehaviorTreeComponent& OwnerComp) const
+{
+	UE_VLOG(OwnerComp.GetOwner(), LogAbilitySystem, Log, TEXT("Ability %s: %s"),
+	        AbilityEndedData.bWasCancelled ? TEXT("canceled") : TEXT("ended"), *GetNameSafe(AbilityEndedData.AbilityThatEnded));
+
+	const EBTNodeResult::Type CancelResult = bFailOnAbilityCancel ? EBTNodeResult::Failed : EBTNodeResult::Succeeded;
+	FinishLatentTask(OwnerComp, AbilityEndedData.bWasCancelled ? CancelResult : EBTNodeResult::Succeeded);
+}
+
+void UBTTask_ActivateAbility::ActivateQueuedAbility(UBehaviorTreeComponent& OwnerComp, UAbilitySystemComponent* AbilitySystem,
+                                                    FGameplayAbilitySpecHandle SpecHandle) const
 {
-	if (!IsValid(OwnerComp))
+	if (!AbilitySystem)
 	{
+		UE_VLOG(OwnerComp.GetOwner(), LogAbilitySystem, Error, TEXT("Ability system was destroyed before queued ability was activated"));
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
 		return;
 	}
 
-	if (bWaitForAbilityEnd && SpecHandle.IsValid() && AbilityEndedData.AbilitySpecHandle == SpecHandle)
+	const EBTNodeResult::Type Result = ActivateAbility(OwnerComp, *AbilitySystem, SpecHandle);
+	if (Result != EBTNodeResult::InProgress)
+	{
+		FinishLatentTask(OwnerComp, Result);
+	}
+}
+
+EBTNodeResult::Type UBTTask_ActivateAbility::ActivateAbility(UBehaviorTreeComponent& OwnerComp, UAbilitySystemComponent& AbilitySystem,
+                                                             FGameplayAbilitySpecHandle SpecHandle) const
+{
+	// the ability may have been removed while queued
+	const FGameplayAbilitySpec* AbilitySpec = AbilitySystem.FindAbilitySpecFromHandle(SpecHandle);
+	if (!AbilitySpec)
+	{
+		UE_VLOG(OwnerComp.GetOwner(), LogAbilitySystem, Error, TEXT("%s no longer has ability to activate"), *GetNameSafe(AbilitySystem.GetOwner()));
+		return EBTNodeResult::Failed;
+	}
+
+	// cancel the ability if requested
+	if (bRestartAbility && AbilitySpec->IsActive())
+	{
+		AbilitySystem.CancelAbilityHandle(SpecHandle);
+	}
+
+	// start waiting before activation, in case it ends immediately
+	if (bWaitForAbilityEnd)
 	{
-		UE_VLOG(OwnerComp->GetOwner(), LogAbilitySystem, Log, TEXT("Ability %s: %s"),
-		        AbilityEndedData.bWasCancelled ? TEXT("canceled") : TEXT("ended"), *GetNameSafe(AbilityEndedData.AbilityThatEnded));
+		if (UBTAbilityTaskSubsystem* AbilityTaskSubsystem = UWorld::GetSubsystem<UBTAbilityTaskSubsystem>(OwnerComp.GetWorld()))
+		{
+			AbilityTaskSubsystem->AddWaitingTask(&AbilitySystem, SpecHandle, OwnerComp, this);
+		}
+	}
 
-		const EBTNodeResult::Type CancelResult = bFailOnAbilityCancel ? EBTNodeResult::Failed : EBTNodeResult::Succeeded;
-		FinishLatentTask(*OwnerComp, AbilityEndedData.bWasCancelled ? CancelResult : EBTNodeResult::Succeeded);
+	const bool bSuccess = AbilitySystem.TryActivateAbility(SpecHandle, true);
+	if (!bSuccess)
+	{
+		// the spec may have moved during activation
+		const FGameplayAbilitySpec* FailedAbilitySpec = AbilitySystem.FindAbilitySpecFromHandle(SpecHandle);
+		UE_VLOG(OwnerComp.GetOwner(), LogAbilitySystem, Error, TEXT("Failed to activate ability: %s"),
+		        FailedAbilitySpec ? *FailedAbilitySpec->GetDebugString() : *SpecHandle.ToString());
+		return EBTNodeResult::Failed;
 	}
+
+	if (bWaitForAbilityEnd)
+	{
+		return EBTNodeResult::InProgress;
+	}
+
+	// TODO: what if it was activated then immediately canceled? this should respect bFailOnAbilityCancel
+	// ability was activated, that's all that matters
+	return EBTNodeResult::Succeeded;
+}
+
+void UBTTask_ActivateAbility::StopWaitingForAbility(UBehaviorTreeComponent& OwnerComp, FBTActivateAbilityTaskMemory& Memory) const
+{
+	if (!Memory.SpecHandle.IsValid())
+	{
+		return;
+	}
+
+	if (UBTAbilityTaskSubsystem* AbilityTaskSubsystem = UWorld::GetSubsystem<UBTAbilityTaskSubsystem>(OwnerComp.GetWorld()))
+	{
+		AbilityTaskSubsystem->CancelQueuedAbilityActivation(OwnerComp, this);
+		AbilityTaskSubsystem->RemoveWaitingTask(Memory.AbilitySystemKey, OwnerComp, this);
+	}
+
+	Memory = FBTActivateAbilityTaskMemory();
 }
 
 FGameplayAbilitySpec* UBTTask_ActivateAbility::GetTargetAbilitySpec(const UAbilitySystemComponent& AbilitySystem) const
 {
 	if (AbilityClass)
 	{
+		if (const UExtendedAbilitySystemComponent* ExtendedAbilitySystem = Cast<UExtendedAbilitySystemComponent>(&AbilitySystem))
+		{
+			const TConstArrayView<FGameplayAbilitySpecHandle> SpecHandles = ExtendedAbilitySystem->GetAbilitySpecHandlesByClass(AbilityClass);
+			return !SpecHandles.IsEmpty() ? AbilitySystem.FindAbilitySpecFromHandle(SpecHandles[0]) : nullptr;
+		}
 		return AbilitySystem.FindAbilitySpecFromClass(AbilityClass);
 	}
 	if (!AbilityTags.IsEmpty())
@@ -130,6 +221,21 @@ FGameplayAbilitySpec* UBTTask_ActivateAbility::GetTargetAbilitySpec(const UAbili
 FGameplayAbilitySpec* UBTTask_ActivateAbility::GetFirstAbilityWithAllTags(const UAbilitySystemComponent& AbilitySystem,
                                                                           const FGameplayTagContainer& RequireTags)
 {
+	// only check abilities that have at least one of the required tags
+	if (const UExtendedAbilitySystemComponent* ExtendedAbilitySystem = Cast<UExtendedAbilitySystemComponent>(&AbilitySystem))
+	{
+		for (const FGameplayAbilitySpecHandle& SpecHandle : ExtendedAbilitySystem->GetAbilitySpecHandlesByTag(RequireTags.First()))
+		{
+			FGameplayAbilitySpec* AbilitySpec = AbilitySystem.FindAbilitySpecFromHandle(SpecHandle);
+			if (AbilitySpec && AbilitySpec->Ability && AbilitySpec->Ability->GetAssetTags().HasAll(RequireTags) &&
+				AbilitySpec->Ability->DoesAbilitySatisfyTagRequirements(AbilitySystem))
+			{
+				return AbilitySpec;
+			}
+		}
+		return nullptr;
+	}
+
 	TArray<FGameplayAbilitySpec*> MatchingAbilities;
 	AbilitySystem.GetActivatableGameplayAbilitySpecsByAllMatchingTags(RequireTags, MatchingAbilities);
 	return !MatchingAbilities.IsEmpty() ? MatchingAbilities[0] : nullptr;
@@ -5,6 +5,8 @@
 
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemLog.h"
+#include "ExtendedAbilitySystemComponent.h"
+#include "Abilities/GameplayAbility.h"
 
 
 UBTTask_CancelAbility::UBTTask_CancelAbility(const FObjectInitializer& ObjectInitializer)
@@ -23,12 +25,52 @@ EBTNodeResult::Type UBTTask_CancelAbility::ExecuteTask(UBehaviorTreeComponent& O
 		return EBTNodeResult::Failed;
 	}
 
+	UExtendedAbilitySystemComponent* ExtendedAbilitySystem = Cast<UExtendedAbilitySystemComponent>(AbilitySystem);
+
 	if (AbilityClass)
 	{
-		AbilitySystem->CancelAbility(AbilityClass->GetDefaultObject<UGameplayAbility>());
+		if (ExtendedAbilitySystem)
+		{
+			// copy handles, since canceling may give or remove abilities
+			const TArray<FGameplayAbilitySpecHandle, TInlineAllocator<4>> SpecHandles(ExtendedAbilitySystem->GetAbilitySpecHandlesByClass(AbilityClass));
+			for (const FGameplayAbilitySpecHandle& SpecHandle : SpecHandles)
+			{
+				AbilitySystem->CancelAbilityHandle(SpecHandle);
+			}
+		}
+		else
+		{
+			AbilitySystem->CancelAbility(AbilityClass->GetDefaultObject<UGameplayAbility>());
+		}
 	}
 
-	if (!WithTags.IsEmpty() || !WithoutTags.IsEmpty())
+	if (ExtendedAbilitySystem && !WithTags.IsEmpty())
+	{
+		// only check abilities that have any of the tags, matching CancelAbilities
+		TArray<FGameplayAbilitySpecHandle, TInlineAllocator<4>> SpecHandles;
+		for (const FGameplayTag& Tag : WithTags)
+		{
+			for (const FGameplayAbilitySpecHandle& SpecHandle : ExtendedAbilitySystem->GetAbilitySpecHandlesByTag(Tag))
+			{
+				if (SpecHandles.Contains(SpecHandle))
+				{
+					continue;
+				}
+
+				const FGameplayAbilitySpec* AbilitySpec = AbilitySystem->FindAbilitySpecFromHandle(SpecHandle);
+				if (AbilitySpec && AbilitySpec->Ability && AbilitySpec->IsActive() && !AbilitySpec->Ability->GetAssetTags().HasAny(WithoutTags))
+				{
+					SpecHandles.Add(SpecHandle);
+				}
+			}
+		}
+
+		for (const FGameplayAbilitySpecHandle& SpecHandle : SpecHandles)
+		{
+			AbilitySystem->CancelAbilityHandle(SpecHandle);
+		}
+	}
+	else if (!WithTags.IsEmpty() || !WithoutTags.IsEmpty())
 	{
 		AbilitySystem->CancelAbilities(&WithTags, &WithoutTags);
 	}
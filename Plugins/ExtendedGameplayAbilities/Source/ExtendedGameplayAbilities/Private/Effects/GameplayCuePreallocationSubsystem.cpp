@@ -0,0 +1,77 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "Effects/GameplayCuePreallocationSubsystem.h"
+
+#include "AbilitySystemGlobals.h"
+#include "ExtendedGameplayAbilitiesSettings.h"
+#include "GameplayCueManager.h"
+#include "Engine/World.h"
+
+
+bool UGameplayCuePreallocationSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (IsRunningDedicatedServer())
+	{
+		// cue notify actors are never spawned on dedicated servers
+		return false;
+	}
+
+	return Super::ShouldCreateSubsystem(Outer);
+}
+
+void UGameplayCuePreallocationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (GetDefault<UExtendedGameplayAbilitiesSettings>()->GameplayCuePreallocationsPerFrame <= 0)
+	{
+		return;
+	}
+
+	if (UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager())
+	{
+		CueManager->ResetPreallocation(&InWorld);
+		bIsPreallocating = true;
+	}
+}
+
+void UGameplayCuePreallocationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bIsPreallocating)
+	{
+		return;
+	}
+
+	UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
+	UWorld* World = GetWorld();
+	if (!CueManager || !World)
+	{
+		return;
+	}
+
+	// UpdatePreallocation spawns at most one actor per call, and does nothing once each class is full
+	const int32 NumPerFrame = GetDefault<UExtendedGameplayAbilitiesSettings>()->GameplayCuePreallocationsPerFrame;
+	for (int32 Idx = 0; Idx < NumPerFrame; ++Idx)
+	{
+		CueManager->UpdatePreallocation(World);
+	}
+}
+
+ETickableTickType UGameplayCuePreallocationSubsystem::GetTickableTickType() const
+{
+	// don't tick the CDO
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UGameplayCuePreallocationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGameplayCuePreallocationSubsystem, STATGROUP_Tickables);
+}
+
+bool UGameplayCuePreallocationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
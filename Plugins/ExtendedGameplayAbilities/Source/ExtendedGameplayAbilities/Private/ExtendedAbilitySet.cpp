@@ -5,6 +5,9 @@
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemLog.h"
 #include "AttributeSet.h"
+#include "ExtendedAbilitySystemComponent.h"
+#include "GameplayEffectAggregator.h"
+#include "Engine/AssetManager.h"
 
 
 // FExtendedAbilitySetHandles
@@ -55,35 +58,77 @@ FExtendedAbilitySetHandles UExtendedAbilitySet::GiveToAbilitySystem(UAbilitySyst
 	Result.AbilitySet = this;
 
 	// give attribute sets first, since passive abilities or effects may need to capture attribute values
+	GiveAttributeSets(AbilitySystem, Result);
+
+	if (!bGrantAsBatch)
+	{
+		GiveAbilities(AbilitySystem, SourceObject, OverrideLevel, Result);
+		GiveEffects(AbilitySystem, SourceObject, OverrideLevel, Result);
+		return Result;
+	}
+
+	UExtendedAbilitySystemComponent* ExtendedAbilitySystem = Cast<UExtendedAbilitySystemComponent>(AbilitySystem);
+	if (ExtendedAbilitySystem)
+	{
+		ExtendedAbilitySystem->BeginAbilitySetGrant();
+	}
+
+	{
+		// new specs are queued as pending adds while locked, and all added together when the lock is released
+		FScopedAbilityListLock AbilityListLock(*AbilitySystem);
+		GiveAbilities(AbilitySystem, SourceObject, OverrideLevel, Result);
+	}
+
+	{
+		// recalculate each dirty aggregator once after all effects are applied
+		FScopedAggregatorOnDirtyBatch AggregatorBatch;
+		GiveEffects(AbilitySystem, SourceObject, OverrideLevel, Result);
+	}
+
+	if (ExtendedAbilitySystem)
+	{
+		ExtendedAbilitySystem->EndAbilitySetGrant(Result);
+	}
+
+	return Result;
+}
+
+void UExtendedAbilitySet::GiveAttributeSets(UAbilitySystemComponent* AbilitySystem, FExtendedAbilitySetHandles& Handles) const
+{
 	for (int32 SetIdx = 0; SetIdx < GrantedAttributes.Num(); ++SetIdx)
 	{
 		const FExtendedAbilitySetAttributes& SetToGrant = GrantedAttributes[SetIdx];
 
-		if (!IsValid(SetToGrant.AttributeSet))
+		// resolves immediately if already loaded, use GiveToAbilitySystemAsync to avoid blocking loads
+		const TSubclassOf<UAttributeSet> AttributeSetClass = SetToGrant.AttributeSet.LoadSynchronous();
+		if (!IsValid(AttributeSetClass))
 		{
 			UE_LOG(LogAbilitySystem, Error, TEXT("GrantedAttributes[%d] on ability set %s is not valid."),
 			       SetIdx, *GetNameSafe(this));
 			continue;
 		}
 
-		if (AbilitySystem->GetAttributeSet(SetToGrant.AttributeSet))
+		if (AbilitySystem->GetAttributeSet(AttributeSetClass))
 		{
 			// attribute set already exists
 			continue;
 		}
 
-		UAttributeSet* NewSet = NewObject<UAttributeSet>(AbilitySystem->GetOwner(), SetToGrant.AttributeSet);
-		AbilitySystem->AddSpawnedAttribute(NewSet);
-
-		Result.AddAttributeSet(NewSet);
+		const UAttributeSet* NewSet = SpawnAttributeSet(AbilitySystem, AttributeSetClass);
+		Handles.AddAttributeSet(NewSet);
 	}
+}
+
+void UExtendedAbilitySet::GiveAbilities(UAbilitySystemComponent* AbilitySystem, UObject* SourceObject, int32 OverrideLevel,
+                                        FExtendedAbilitySetHandles& Handles) const
+{
+	Handles.AbilitySpecHandles.Reserve(Handles.AbilitySpecHandles.Num() + GrantedAbilities.Num());
 
-	// give abilities
 	for (int32 AbilityIdx = 0; AbilityIdx < GrantedAbilities.Num(); ++AbilityIdx)
 	{
 		const FExtendedAbilitySetAbility& AbilityToGrant = GrantedAbilities[AbilityIdx];
 
-		if (!IsValid(AbilityToGrant.Ability))
+		if (!IsValid(AbilityToGrant.Ability.LoadSynchronous()))
 		{
 			UE_LOG(LogAbilitySystem, Error, TEXT("GrantedAbilities[%d] on ability set %s is not valid."),
 			       AbilityIdx, *GetNameSafe(this));
@@ -93,15 +138,20 @@ FExtendedAbilitySetHandles UExtendedAbilitySet::GiveToAbilitySystem(UAbilitySyst
 		FGameplayAbilitySpec AbilitySpec = CreateAbilitySpec(AbilityToGrant, AbilitySystem, SourceObject, OverrideLevel);
 
 		const FGameplayAbilitySpecHandle AbilitySpecHandle = AbilitySystem->GiveAbility(AbilitySpec);
-		Result.AddAbilitySpecHandle(AbilitySpecHandle);
+		Handles.AddAbilitySpecHandle(AbilitySpecHandle);
 	}
+}
+
+void UExtendedAbilitySet::GiveEffects(UAbilitySystemComponent* AbilitySystem, UObject* SourceObject, int32 OverrideLevel,
+                                      FExtendedAbilitySetHandles& Handles) const
+{
+	Handles.GameplayEffectHandles.Reserve(Handles.GameplayEffectHandles.Num() + GrantedEffects.Num());
 
-	// give effects
 	for (int32 EffectIdx = 0; EffectIdx < GrantedEffects.Num(); ++EffectIdx)
 	{
 		const FExtendedAbilitySetEffect& EffectToGrant = GrantedEffects[EffectIdx];
 
-		if (!IsValid(EffectToGrant.Effect))
+		if (!IsValid(EffectToGrant.Effect.LoadSynchronous()))
 		{
 			UE_LOG(LogAbilitySystem, Error, TEXT("GrantedEffects[%d] on ability set %s is not valid."),
 			       EffectIdx, *GetNameSafe(this));
@@ -111,12 +161,336 @@ FExtendedAbilitySetHandles UExtendedAbilitySet::GiveToAbilitySystem(UAbilitySyst
 		FGameplayEffectSpec EffectSpec = CreateEffectSpec(EffectToGrant, AbilitySystem, SourceObject, OverrideLevel);
 
 		const FActiveGameplayEffectHandle EffectHandle = AbilitySystem->ApplyGameplayEffectSpecToSelf(EffectSpec);
-		Result.AddGameplayEffectHandle(EffectHandle);
+		Handles.AddGameplayEffectHandle(EffectHandle);
+	}
+}
+
+FExtendedAbilitySetHandles UExtendedAbilitySet::SwapAbilitySet(UAbilitySystemComponent* AbilitySystem,
+                                                               FExtendedAbilitySetHandles& OldHandles,
+                                                               UObject* SourceObject,
+                                                               int32 OverrideLevel,
+                                                               bool bEndImmediately,
+                                                               bool bKeepAttributeSets,
+                                                               bool bKeepEffectsFromOldSource) const
+{
+	check(AbilitySystem);
+
+	if (!AbilitySystem->IsOwnerActorAuthoritative())
+	{
+		return FExtendedAbilitySetHandles();
+	}
+
+	FExtendedAbilitySetHandles Result;
+
+	Result.AbilitySet = this;
+
+	UExtendedAbilitySystemComponent* ExtendedAbilitySystem = bGrantAsBatch ? Cast<UExtendedAbilitySystemComponent>(AbilitySystem) : nullptr;
+	if (ExtendedAbilitySystem)
+	{
+		ExtendedAbilitySystem->BeginAbilitySetGrant();
+	}
+
+	// give new attribute sets first, and keep previously spawned ones that are still granted
+	GiveAttributeSets(AbilitySystem, Result);
+
+	TArray<TSubclassOf<UAttributeSet>> AttributeSetsToRemove;
+	for (const TSubclassOf<UAttributeSet>& AttributeSetClass : OldHandles.AttributeSetClasses)
+	{
+		const bool bIsStillGranted = GrantedAttributes.ContainsByPredicate([&AttributeSetClass](const FExtendedAbilitySetAttributes& SetToGrant)
+		{
+			return SetToGrant.AttributeSet.Get() == AttributeSetClass;
+		});
+
+		if (bIsStillGranted)
+		{
+			Result.AttributeSetClasses.AddUnique(AttributeSetClass);
+		}
+		else
+		{
+			AttributeSetsToRemove.Add(AttributeSetClass);
+		}
+	}
+
+	{
+		FScopedAbilityListLock AbilityListLock(*AbilitySystem);
+		SwapAbilities(AbilitySystem, OldHandles, SourceObject, OverrideLevel, bEndImmediately, Result);
+	}
+
+	{
+		FScopedAggregatorOnDirtyBatch AggregatorBatch;
+		SwapEffects(AbilitySystem, OldHandles, SourceObject, bKeepEffectsFromOldSource, OverrideLevel, Result);
+	}
+
+	// remove old attribute sets last, since removed effects may still have been modifying them
+	if (!bKeepAttributeSets)
+	{
+		for (const TSubclassOf<UAttributeSet>& AttributeSetClass : AttributeSetsToRemove)
+		{
+			DespawnAttributeSet(AbilitySystem, AttributeSetClass);
+		}
+	}
+
+	OldHandles.Reset();
+
+	if (ExtendedAbilitySystem)
+	{
+		ExtendedAbilitySystem->EndAbilitySetGrant(Result);
 	}
 
 	return Result;
 }
 
+void UExtendedAbilitySet::SwapAbilities(UAbilitySystemComponent* AbilitySystem, const FExtendedAbilitySetHandles& OldHandles, UObject* SourceObject,
+                                        int32 OverrideLevel, bool bEndImmediately, FExtendedAbilitySetHandles& Handles) const
+{
+	// old abilities that haven't been matched to a granted ability yet
+	TArray<FGameplayAbilitySpecHandle> UnmatchedHandles;
+	UnmatchedHandles.Reserve(OldHandles.AbilitySpecHandles.Num());
+	for (const FGameplayAbilitySpecHandle& Handle : OldHandles.AbilitySpecHandles)
+	{
+		const FGameplayAbilitySpec* Spec = AbilitySystem->FindAbilitySpecFromHandle(Handle);
+		if (Spec && !Spec->PendingRemove)
+		{
+			UnmatchedHandles.Add(Handle);
+		}
+	}
+
+	Handles.AbilitySpecHandles.Reserve(Handles.AbilitySpecHandles.Num() + GrantedAbilities.Num());
+
+	for (int32 AbilityIdx = 0; AbilityIdx < GrantedAbilities.Num(); ++AbilityIdx)
+	{
+		const FExtendedAbilitySetAbility& AbilityToGrant = GrantedAbilities[AbilityIdx];
+
+		if (!IsValid(AbilityToGrant.Ability.LoadSynchronous()))
+		{
+			UE_LOG(LogAbilitySystem, Error, TEXT("GrantedAbilities[%d] on ability set %s is not valid."),
+			       AbilityIdx, *GetNameSafe(this));
+			continue;
+		}
+
+		FGameplayAbilitySpec AbilitySpec = CreateAbilitySpec(AbilityToGrant, AbilitySystem, SourceObject, OverrideLevel);
+
+		const int32 MatchIdx = UnmatchedHandles.IndexOfByPredicate([AbilitySystem, &AbilitySpec](const FGameplayAbilitySpecHandle& Handle)
+		{
+			const FGameplayAbilitySpec* OldSpec = AbilitySystem->FindAbilitySpecFromHandle(Handle);
+			return OldSpec && OldSpec->Ability == AbilitySpec.Ability && OldSpec->GetDynamicSpecSourceTags() == AbilitySpec.GetDynamicSpecSourceTags();
+		});
+
+		if (MatchIdx == INDEX_NONE)
+		{
+			const FGameplayAbilitySpecHandle AbilitySpecHandle = AbilitySystem->GiveAbility(AbilitySpec);
+			Handles.AddAbilitySpecHandle(AbilitySpecHandle);
+			continue;
+		}
+
+		// keep the existing spec, only updating what changed
+		const FGameplayAbilitySpecHandle MatchedHandle = UnmatchedHandles[MatchIdx];
+		UnmatchedHandles.RemoveAtSwap(MatchIdx);
+
+		FGameplayAbilitySpec* OldSpec = AbilitySystem->FindAbilitySpecFromHandle(MatchedHandle);
+		if (OldSpec->Level != AbilitySpec.Level || OldSpec->SourceObject != AbilitySpec.SourceObject)
+		{
+			OldSpec->Level = AbilitySpec.Level;
+			OldSpec->SourceObject = AbilitySpec.SourceObject;
+			AbilitySystem->MarkAbilitySpecDirty(*OldSpec);
+		}
+
+		Handles.AddAbilitySpecHandle(MatchedHandle);
+	}
+
+	// remove old abilities that are no longer granted
+	for (const FGameplayAbilitySpecHandle& Handle : UnmatchedHandles)
+	{
+		if (bEndImmediately)
+		{
+			AbilitySystem->ClearAbility(Handle);
+		}
+		else
+		{
+			AbilitySystem->SetRemoveAbilityOnEnd(Handle);
+		}
+	}
+}
+
+void UExtendedAbilitySet::SwapEffects(UAbilitySystemComponent* AbilitySystem, const FExtendedAbilitySetHandles& OldHandles, UObject* SourceObject,
+                                      bool bKeepEffectsFromOldSource, int32 OverrideLevel, FExtendedAbilitySetHandles& Handles) const
+{
+	// old effects that haven't been matched to a granted effect yet
+	TArray<FActiveGameplayEffectHandle> UnmatchedHandles;
+	UnmatchedHandles.Reserve(OldHandles.GameplayEffectHandles.Num());
+	for (const FActiveGameplayEffectHandle& Handle : OldHandles.GameplayEffectHandles)
+	{
+		if (AbilitySystem->GetActiveGameplayEffect(Handle))
+		{
+			UnmatchedHandles.Add(Handle);
+		}
+	}
+
+	Handles.GameplayEffectHandles.Reserve(Handles.GameplayEffectHandles.Num() + GrantedEffects.Num());
+
+	for (int32 EffectIdx = 0; EffectIdx < GrantedEffects.Num(); ++EffectIdx)
+	{
+		const FExtendedAbilitySetEffect& EffectToGrant = GrantedEffects[EffectIdx];
+
+		const UClass* EffectClass = EffectToGrant.Effect.LoadSynchronous();
+		if (!IsValid(EffectClass))
+		{
+			UE_LOG(LogAbilitySystem, Error, TEXT("GrantedEffects[%d] on ability set %s is not valid."),
+			       EffectIdx, *GetNameSafe(this));
+			continue;
+		}
+
+		const UGameplayEffect* EffectCDO = EffectClass->GetDefaultObject<UGameplayEffect>();
+		// effects from a different source are reapplied by default, so that their context reports the new source object
+		const int32 MatchIdx = UnmatchedHandles.IndexOfByPredicate(
+			[AbilitySystem, EffectCDO, SourceObject, bKeepEffectsFromOldSource](const FActiveGameplayEffectHandle& Handle)
+			{
+				const FActiveGameplayEffect* OldEffect = AbilitySystem->GetActiveGameplayEffect(Handle);
+				return OldEffect && OldEffect->Spec.Def == EffectCDO &&
+					(bKeepEffectsFromOldSource || OldEffect->Spec.GetEffectContext().GetSourceObject() == SourceObject);
+			});
+
+		if (MatchIdx == INDEX_NONE)
+		{
+			FGameplayEffectSpec EffectSpec = CreateEffectSpec(EffectToGrant, AbilitySystem, SourceObject, OverrideLevel);
+
+			const FActiveGameplayEffectHandle EffectHandle = AbilitySystem->ApplyGameplayEffectSpecToSelf(EffectSpec);
+			Handles.AddGameplayEffectHandle(EffectHandle);
+			continue;
+		}
+
+		// keep the existing effect, only updating its level if needed
+		const FActiveGameplayEffectHandle MatchedHandle = UnmatchedHandles[MatchIdx];
+		UnmatchedHandles.RemoveAtSwap(MatchIdx);
+
+		const FActiveGameplayEffect* MatchedEffect = AbilitySystem->GetActiveGameplayEffect(MatchedHandle);
+		const float Level = OverrideLevel >= 0 ? OverrideLevel : EffectToGrant.Level;
+		if (MatchedEffect->Spec.GetLevel() != Level)
+		{
+			AbilitySystem->SetActiveGameplayEffectLevel(MatchedHandle, Level);
+		}
+
+		Handles.AddGameplayEffectHandle(MatchedHandle);
+	}
+
+	// remove old effects that are no longer granted
+	for (const FActiveGameplayEffectHandle& Handle : UnmatchedHandles)
+	{
+		AbilitySystem->RemoveActiveGameplayEffect(Handle);
+	}
+}
+
+TSharedPtr<FStreamableHandle> UExtendedAbilitySet::GiveToAbilitySystemAsync(UAbilitySystemComponent* AbilitySystem, UObject* SourceObject,
+                                                                           int32 OverrideLevel, FExtendedAbilitySetGivenDelegate OnGiven) const
+{
+	check(AbilitySystem);
+
+	if (!AbilitySystem->IsOwnerActorAuthoritative())
+	{
+		OnGiven.ExecuteIfBound(FExtendedAbilitySetHandles());
+		return nullptr;
+	}
+
+	if (IsAbilitySetLoaded())
+	{
+		const FExtendedAbilitySetHandles Handles = GiveToAbilitySystem(AbilitySystem, SourceObject, OverrideLevel);
+		OnGiven.ExecuteIfBound(Handles);
+		return nullptr;
+	}
+
+	TWeakObjectPtr<const UExtendedAbilitySet> WeakThis(this);
+	TWeakObjectPtr<UAbilitySystemComponent> WeakAbilitySystem(AbilitySystem);
+	TWeakObjectPtr<UObject> WeakSourceObject(SourceObject);
+	const bool bHasSourceObject = SourceObject != nullptr;
+
+	return PreloadAbilitySet(FStreamableDelegate::CreateLambda(
+		[WeakThis, WeakAbilitySystem, WeakSourceObject, bHasSourceObject, OverrideLevel, OnGiven = MoveTemp(OnGiven)]()
+		{
+			const UExtendedAbilitySet* AbilitySet = WeakThis.Get();
+			UAbilitySystemComponent* AbilitySystem = WeakAbilitySystem.Get();
+			if (!AbilitySet || !AbilitySystem || (bHasSourceObject && !WeakSourceObject.IsValid()))
+			{
+				OnGiven.ExecuteIfBound(FExtendedAbilitySetHandles());
+				return;
+			}
+
+			const FExtendedAbilitySetHandles Handles = AbilitySet->GiveToAbilitySystem(AbilitySystem, WeakSourceObject.Get(), OverrideLevel);
+			OnGiven.ExecuteIfBound(Handles);
+		}));
+}
+
+TSharedPtr<FStreamableHandle> UExtendedAbilitySet::PreloadAbilitySet(FStreamableDelegate OnLoaded) const
+{
+	TArray<FSoftObjectPath> AssetsToLoad;
+	GetAssetsToLoad(AssetsToLoad);
+
+	if (AssetsToLoad.IsEmpty())
+	{
+		OnLoaded.ExecuteIfBound();
+		return nullptr;
+	}
+
+	return UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetsToLoad, MoveTemp(OnLoaded), FStreamableManager::AsyncLoadHighPriority);
+}
+
+bool UExtendedAbilitySet::IsAbilitySetLoaded() const
+{
+	for (const FExtendedAbilitySetAbility& AbilityToGrant : GrantedAbilities)
+	{
+		if (!AbilityToGrant.Ability.IsNull() && !AbilityToGrant.Ability.IsValid())
+		{
+			return false;
+		}
+	}
+
+	for (const FExtendedAbilitySetEffect& EffectToGrant : GrantedEffects)
+	{
+		if (!EffectToGrant.Effect.IsNull() && !EffectToGrant.Effect.IsValid())
+		{
+			return false;
+		}
+	}
+
+	for (const FExtendedAbilitySetAttributes& SetToGrant : GrantedAttributes)
+	{
+		if (!SetToGrant.AttributeSet.IsNull() && !SetToGrant.AttributeSet.IsValid())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UExtendedAbilitySet::GetAssetsToLoad(TArray<FSoftObjectPath>& OutAssetPaths) const
+{
+	OutAssetPaths.Reserve(OutAssetPaths.Num() + GrantedAbilities.Num() + GrantedEffects.Num() + GrantedAttributes.Num());
+
+	for (const FExtendedAbilitySetAbility& AbilityToGrant : GrantedAbilities)
+	{
+		if (!AbilityToGrant.Ability.IsNull())
+		{
+			OutAssetPaths.AddUnique(AbilityToGrant.Ability.ToSoftObjectPath());
+		}
+	}
+
+	for (const FExtendedAbilitySetEffect& EffectToGrant : GrantedEffects)
+	{
+		if (!EffectToGrant.Effect.IsNull())
+		{
+			OutAssetPaths.AddUnique(EffectToGrant.Effect.ToSoftObjectPath());
+		}
+	}
+
+	for (const FExtendedAbilitySetAttributes& SetToGrant : GrantedAttributes)
+	{
+		if (!SetToGrant.AttributeSet.IsNull())
+		{
+			OutAssetPaths.AddUnique(SetToGrant.AttributeSet.ToSoftObjectPath());
+		}
+	}
+}
+
 void UExtendedAbilitySet::RemoveFromAbilitySystem(UAbilitySystemComponent* AbilitySystem,
                                                   FExtendedAbilitySetHandles& AbilitySetHandles,
                                                   bool bEndAbilities,
@@ -159,22 +533,50 @@ void UExtendedAbilitySet::RemoveFromAbilitySystem(UAbilitySystemComponent* Abili
 	{
 		for (const TSubclassOf<UAttributeSet>& AttributeSetClass : AbilitySetHandles.AttributeSetClasses)
 		{
-			if (UAttributeSet* AttributeSet = const_cast<UAttributeSet*>(AbilitySystem->GetAttributeSet(AttributeSetClass)))
-			{
-				AbilitySystem->RemoveSpawnedAttribute(AttributeSet);
-			}
+			DespawnAttributeSet(AbilitySystem, AttributeSetClass);
 		}
 	}
 
 	AbilitySetHandles.Reset();
 }
 
+UAttributeSet* UExtendedAbilitySet::SpawnAttributeSet(UAbilitySystemComponent* AbilitySystem, TSubclassOf<UAttributeSet> AttributeSetClass)
+{
+	if (UExtendedAbilitySystemComponent* ExtendedAbilitySystem = Cast<UExtendedAbilitySystemComponent>(AbilitySystem))
+	{
+		return ExtendedAbilitySystem->SpawnAttributeSet(AttributeSetClass);
+	}
+
+	UAttributeSet* NewSet = NewObject<UAttributeSet>(AbilitySystem->GetOwner(), AttributeSetClass);
+	AbilitySystem->AddSpawnedAttribute(NewSet);
+	return NewSet;
+}
+
+void UExtendedAbilitySet::DespawnAttributeSet(UAbilitySystemComponent* AbilitySystem, TSubclassOf<UAttributeSet> AttributeSetClass)
+{
+	UAttributeSet* AttributeSet = const_cast<UAttributeSet*>(AbilitySystem->GetAttributeSet(AttributeSetClass));
+	if (!AttributeSet)
+	{
+		return;
+	}
+
+	if (UExtendedAbilitySystemComponent* ExtendedAbilitySystem = Cast<UExtendedAbilitySystemComponent>(AbilitySystem))
+	{
+		ExtendedAbilitySystem->DespawnAttributeSet(AttributeSet);
+	}
+	else
+	{
+		AbilitySystem->RemoveSpawnedAttribute(AttributeSet);
+	}
+}
+
 FGameplayAbilitySpec UExtendedAbilitySet::CreateAbilitySpec(const FExtendedAbilitySetAbility& AbilityToGrant, UAbilitySystemComponent* AbilitySystem,
                                                             UObject* SourceObject, int32 OverrideLevel) const
 {
-	check(AbilityToGrant.Ability);
+	const UClass* AbilityClass = AbilityToGrant.Ability.Get();
+	check(AbilityClass);
 
-	UGameplayAbility* AbilityCDO = AbilityToGrant.Ability->GetDefaultObject<UGameplayAbility>();
+	UGameplayAbility* AbilityCDO = AbilityClass->GetDefaultObject<UGameplayAbility>();
 
 	FGameplayAbilitySpec AbilitySpec(AbilityCDO, OverrideLevel >= 0 ? OverrideLevel : AbilityToGrant.Level);
 	AbilitySpec.SourceObject = SourceObject;
@@ -186,10 +588,11 @@ FGameplayAbilitySpec UExtendedAbilitySet::CreateAbilitySpec(const FExtendedAbili
 FGameplayEffectSpec UExtendedAbilitySet::CreateEffectSpec(const FExtendedAbilitySetEffect& EffectToGrant, UAbilitySystemComponent* AbilitySystem,
                                                           UObject* SourceObject, int32 OverrideLevel) const
 {
-	check(EffectToGrant.Effect);
+	const UClass* EffectClass = EffectToGrant.Effect.Get();
+	check(EffectClass);
 	check(AbilitySystem);
 
-	const UGameplayEffect* EffectCDO = EffectToGrant.Effect->GetDefaultObject<UGameplayEffect>();
+	const UGameplayEffect* EffectCDO = EffectClass->GetDefaultObject<UGameplayEffect>();
 
 	FGameplayEffectContextHandle ContextHandle = AbilitySystem->MakeEffectContext();
 	ContextHandle.AddSourceObject(SourceObject);
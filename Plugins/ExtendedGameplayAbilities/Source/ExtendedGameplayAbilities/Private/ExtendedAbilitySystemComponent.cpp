@@ -4,6 +4,7 @@
 
 #include "ExtendedAbilitySet.h"
 #include "ExtendedAbilityTagRelationshipMapping.h"
+#include "ExtendedAttributeSet.h"
 #include "ExtendedGameplayAbility.h"
 
 
@@ -47,6 +48,57 @@ TArray<FActiveGameplayEffectHandle> UExtendedAbilitySystemComponent::ApplyGamepl
 	return Result;
 }
 
+UAttributeSet* UExtendedAbilitySystemComponent::SpawnAttributeSet(TSubclassOf<UAttributeSet> AttributeSetClass)
+{
+	check(AttributeSetClass);
+
+	UAttributeSet* AttributeSet = nullptr;
+
+	const int32 RecycledIdx = RecycledAttributeSets.IndexOfByPredicate([AttributeSetClass](const UAttributeSet* RecycledSet)
+	{
+		return RecycledSet->GetClass() == AttributeSetClass;
+	});
+
+	if (RecycledIdx != INDEX_NONE)
+	{
+		AttributeSet = RecycledAttributeSets[RecycledIdx];
+		RecycledAttributeSets.RemoveAtSwap(RecycledIdx);
+	}
+	else
+	{
+		AttributeSet = NewObject<UAttributeSet>(GetOwner(), AttributeSetClass);
+	}
+
+	AddSpawnedAttribute(AttributeSet);
+	OnAttributeSetsChangedEvent.Broadcast();
+	return AttributeSet;
+}
+
+void UExtendedAbilitySystemComponent::DespawnAttributeSet(UAttributeSet* AttributeSet)
+{
+	if (!AttributeSet)
+	{
+		return;
+	}
+
+	RemoveSpawnedAttribute(AttributeSet);
+	OnAttributeSetsChangedEvent.Broadcast();
+
+	// only reuse sets owned by this actor, since they may be replicated as its subobjects
+	if (bRecycleAttributeSets && IsValid(AttributeSet) && AttributeSet->GetOuter() == GetOwner())
+	{
+		UExtendedAttributeSet::ResetAttributeValues(AttributeSet);
+		RecycledAttributeSets.AddUnique(AttributeSet);
+	}
+}
+
+void UExtendedAbilitySystemComponent::OnRep_SpawnedAttributes(const TArray<UAttributeSet*>& PreviousSpawnedAttributes)
+{
+	Super::OnRep_SpawnedAttributes(PreviousSpawnedAttributes);
+
+	OnAttributeSetsChangedEvent.Broadcast();
+}
+
 void UExtendedAbilitySystemComponent::CancelAbilitiesWithState(FGameplayTagContainer WithStateTags, UGameplayAbility* IgnoreAbility)
 {
 	const FGameplayAbilityActorInfo* ActorInfo = AbilityActorInfo.Get();
@@ -96,6 +148,10 @@ void UExtendedAbilitySystemComponent::InitializeComponent()
 		SetLooseGameplayTagCount(DefaultTag, 1);
 	}
 
+	// keep the gameplay cue effect index up to date
+	OnActiveGameplayEffectAddedDelegateToSelf.AddUObject(this, &UExtendedAbilitySystemComponent::OnActiveGameplayEffectAddedToSelf);
+	OnAnyGameplayEffectRemovedDelegate().AddUObject(this, &UExtendedAbilitySystemComponent::OnActiveGameplayEffectRemovedFromSelf);
+
 	// apply startup ability sets
 	for (const UExtendedAbilitySet* AbilitySet : StartupAbilitySets)
 	{
@@ -107,7 +163,10 @@ void UExtendedAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& Abilit
 {
 	Super::OnGiveAbility(AbilitySpec);
 
-	if (AbilitySpec.Ability)
+	AddToAbilityIndex(AbilitySpec);
+
+	// abilities given during a batched ability set grant are reported once by OnAbilitySetGrantedEvent
+	if (AbilitySpec.Ability && !IsGrantingAbilitySet())
 	{
 		OnGiveAbilityEvent.Broadcast(AbilitySpec);
 	}
@@ -117,12 +176,27 @@ void UExtendedAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& Abil
 {
 	Super::OnRemoveAbility(AbilitySpec);
 
+	RemoveFromAbilityIndex(AbilitySpec);
+
 	if (AbilitySpec.Ability)
 	{
 		OnRemoveAbilityEvent.Broadcast(AbilitySpec);
 	}
 }
 
+void UExtendedAbilitySystemComponent::BeginAbilitySetGrant()
+{
+	++AbilitySetGrantCount;
+}
+
+void UExtendedAbilitySystemComponent::EndAbilitySetGrant(const FExtendedAbilitySetHandles& AbilitySetHandles)
+{
+	check(AbilitySetGrantCount > 0);
+	--AbilitySetGrantCount;
+
+	OnAbilitySetGrantedEvent.Broadcast(AbilitySetHandles);
+}
+
 void UExtendedAbilitySystemComponent::ApplyAbilityBlockAndCancelTags(const FGameplayTagContainer& AbilityTags, UGameplayAbility* RequestingAbility,
                                                                      bool bEnableBlockTags, const FGameplayTagContainer& BlockTags,
                                                                      bool bExecuteCancelTags, const FGameplayTagContainer& CancelTags)
@@ -225,3 +299,161 @@ void UExtendedAbilitySystemComponent::ReleaseInputTag(const FGameplayTag& InputT
 {
 	AbilityTagInputReleased(InputTag);
 }
+
+void UExtendedAbilitySystemComponent::GetActiveEffectsGrantingGameplayCue(const FGameplayTag& GameplayCueTag, TArray<FActiveGameplayEffectHandle>& OutEffectHandles)
+{
+	OutEffectHandles.Reset();
+	if (!GameplayCueTag.IsValid())
+	{
+		return;
+	}
+
+	// only true while an effect is being applied, between its cue events and the effect added event
+	if (GetActiveGameplayEffects().GetNumGameplayEffects() > GameplayCueIndexedEffects.Num())
+	{
+		CatchUpGameplayCueEffectIndex();
+	}
+
+	if (const TArray<FActiveGameplayEffectHandle>* EffectHandles = GameplayCueEffectIndex.Find(GameplayCueTag))
+	{
+		OutEffectHandles.Reserve(EffectHandles->Num());
+		for (const FActiveGameplayEffectHandle& EffectHandle : *EffectHandles)
+		{
+			// effects remain indexed until their removal has finished, skip them while gameplay cues are being removed
+			const FActiveGameplayEffect* ActiveEffect = GetActiveGameplayEffect(EffectHandle);
+			if (ActiveEffect && !ActiveEffect->IsPendingRemove)
+			{
+				OutEffectHandles.Add(EffectHandle);
+			}
+		}
+	}
+}
+
+TConstArrayView<FGameplayAbilitySpecHandle> UExtendedAbilitySystemComponent::GetAbilitySpecHandlesByClass(
+	TSubclassOf<UGameplayAbility> AbilityClass) const
+{
+	const TArray<FGameplayAbilitySpecHandle>* SpecHandles = AbilityClassIndex.Find(TObjectKey<UClass>(AbilityClass.Get()));
+	return SpecHandles ? TConstArrayView<FGameplayAbilitySpecHandle>(*SpecHandles) : TConstArrayView<FGameplayAbilitySpecHandle>();
+}
+
+TConstArrayView<FGameplayAbilitySpecHandle> UExtendedAbilitySystemComponent::GetAbilitySpecHandlesByTag(const FGameplayTag& AbilityTag) const
+{
+	const TArray<FGameplayAbilitySpecHandle>* SpecHandles = AbilityTagIndex.Find(AbilityTag);
+	return SpecHandles ? TConstArrayView<FGameplayAbilitySpecHandle>(*SpecHandles) : TConstArrayView<FGameplayAbilitySpecHandle>();
+}
+
+void UExtendedAbilitySystemComponent::AddToAbilityIndex(const FGameplayAbilitySpec& AbilitySpec)
+{
+	if (!AbilitySpec.Ability || !AbilitySpec.Handle.IsValid())
+	{
+		return;
+	}
+
+	AbilityClassIndex.FindOrAdd(TObjectKey<UClass>(AbilitySpec.Ability->GetClass())).AddUnique(AbilitySpec.Handle);
+
+	for (const FGameplayTag& AbilityTag : AbilitySpec.Ability->GetAssetTags().GetGameplayTagParents())
+	{
+		AbilityTagIndex.FindOrAdd(AbilityTag).AddUnique(AbilitySpec.Handle);
+	}
+}
+
+void UExtendedAbilitySystemComponent::RemoveFromAbilityIndex(const FGameplayAbilitySpec& AbilitySpec)
+{
+	if (!AbilitySpec.Ability || !AbilitySpec.Handle.IsValid())
+	{
+		return;
+	}
+
+	const TObjectKey<UClass> AbilityClassKey(AbilitySpec.Ability->GetClass());
+	if (TArray<FGameplayAbilitySpecHandle>* SpecHandles = AbilityClassIndex.Find(AbilityClassKey))
+	{
+		SpecHandles->Remove(AbilitySpec.Handle);
+		if (SpecHandles->IsEmpty())
+		{
+			AbilityClassIndex.Remove(AbilityClassKey);
+		}
+	}
+
+	for (const FGameplayTag& AbilityTag : AbilitySpec.Ability->GetAssetTags().GetGameplayTagParents())
+	{
+		if (TArray<FGameplayAbilitySpecHandle>* SpecHandles = AbilityTagIndex.Find(AbilityTag))
+		{
+			SpecHandles->Remove(AbilitySpec.Handle);
+			if (SpecHandles->IsEmpty())
+			{
+				AbilityTagIndex.Remove(AbilityTag);
+			}
+		}
+	}
+}
+
+void UExtendedAbilitySystemComponent::CatchUpGameplayCueEffectIndex()
+{
+	for (FActiveGameplayEffectsContainer::ConstIterator EffectIt = GetActiveGameplayEffects().CreateConstIterator(); EffectIt; ++EffectIt)
+	{
+		const FActiveGameplayEffect& Effect = *EffectIt;
+		if (!Effect.IsPendingRemove && !GameplayCueIndexedEffects.Contains(Effect.Handle))
+		{
+			AddToGameplayCueEffectIndex(Effect.Spec, Effect.Handle);
+		}
+	}
+}
+
+void UExtendedAbilitySystemComponent::AddToGameplayCueEffectIndex(const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle)
+{
+	if (!Spec.Def || !Handle.IsValid())
+	{
+		return;
+	}
+
+	bool bIsAlreadyIndexed = false;
+	GameplayCueIndexedEffects.Add(Handle, &bIsAlreadyIndexed);
+	if (bIsAlreadyIndexed)
+	{
+		return;
+	}
+
+	for (const FGameplayEffectCue& EffectCue : Spec.Def->GameplayCues)
+	{
+		// include parent tags to match the behavior of FGameplayTagContainer::HasTag
+		for (const FGameplayTag& CueTag : EffectCue.GameplayCueTags.GetGameplayTagParents())
+		{
+			GameplayCueEffectIndex.FindOrAdd(CueTag).AddUnique(Handle);
+		}
+	}
+}
+
+void UExtendedAbilitySystemComponent::RemoveFromGameplayCueEffectIndex(const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle)
+{
+	if (!Spec.Def || GameplayCueIndexedEffects.Remove(Handle) == 0)
+	{
+		return;
+	}
+
+	for (const FGameplayEffectCue& EffectCue : Spec.Def->GameplayCues)
+	{
+		for (const FGameplayTag& CueTag : EffectCue.GameplayCueTags.GetGameplayTagParents())
+		{
+			if (TArray<FActiveGameplayEffectHandle>* EffectHandles = GameplayCueEffectIndex.Find(CueTag))
+			{
+				EffectHandles->RemoveSingleSwap(Handle);
+				if (EffectHandles->IsEmpty())
+				{
+					GameplayCueEffectIndex.Remove(CueTag);
+				}
+			}
+		}
+	}
+}
+
+void UExtendedAbilitySystemComponent::OnActiveGameplayEffectAddedToSelf(UAbilitySystemComponent* AbilitySystemComponent,
+                                                                        const FGameplayEffectSpec& Spec,
+                                                                        FActiveGameplayEffectHandle Handle)
+{
+	AddToGameplayCueEffectIndex(Spec, Handle);
+}
+
+void UExtendedAbilitySystemComponent::OnActiveGameplayEffectRemovedFromSelf(const FActiveGameplayEffect& ActiveEffect)
+{
+	RemoveFromGameplayCueEffectIndex(ActiveEffect.Spec, ActiveEffect.Handle);
+}
@@ -163,6 +163,14 @@ TArray<FActiveGameplayEffectHandle> UExtendedAbilitySystemStatics::GetActiveEffe
 		return TArray<FActiveGameplayEffectHandle>();
 	}
 
+	if (UExtendedAbilitySystemComponent* ExtendedAbilitySystem = Cast<UExtendedAbilitySystemComponent>(AbilitySystem))
+	{
+		// use the indexed lookup
+		TArray<FActiveGameplayEffectHandle> Result;
+		ExtendedAbilitySystem->GetActiveEffectsGrantingGameplayCue(GameplayCueTag, Result);
+		return Result;
+	}
+
 	FGameplayEffectQuery Query;
 	Query.CustomMatchDelegate = FActiveGameplayEffectQueryCustomMatch::CreateLambda([&GameplayCueTag](const FActiveGameplayEffect& ActiveEffect)
 	{
@@ -214,6 +222,49 @@ FExtendedAbilitySetHandles UExtendedAbilitySystemStatics::GiveAbilitySet(UAbilit
 	return AbilitySet->GiveToAbilitySystem(AbilitySystem, SourceObject, OverrideLevel);
 }
 
+FExtendedAbilitySetHandles UExtendedAbilitySystemStatics::SwapAbilitySet(UAbilitySystemComponent* AbilitySystem,
+                                                                         FExtendedAbilitySetHandles& OldHandles,
+                                                                         UExtendedAbilitySet* NewAbilitySet,
+                                                                         UObject* SourceObject,
+                                                                         int32 OverrideLevel,
+                                                                         bool bEndImmediately,
+                                                                         bool bKeepAttributeSets,
+                                                                         bool bKeepEffectsFromOldSource)
+{
+	if (!AbilitySystem)
+	{
+		return FExtendedAbilitySetHandles();
+	}
+
+	if (!NewAbilitySet)
+	{
+		RemoveAbilitySet(AbilitySystem, OldHandles, bEndImmediately, bKeepAttributeSets);
+		return FExtendedAbilitySetHandles();
+	}
+
+	return NewAbilitySet->SwapAbilitySet(AbilitySystem, OldHandles, SourceObject, OverrideLevel, bEndImmediately, bKeepAttributeSets,
+	                                     bKeepEffectsFromOldSource);
+}
+
+void UExtendedAbilitySystemStatics::GiveAbilitySetAsync(UAbilitySystemComponent* AbilitySystem,
+                                                        UExtendedAbilitySet* AbilitySet,
+                                                        const FExtendedAbilitySetGivenDynDelegate& OnGiven,
+                                                        UObject* SourceObject,
+                                                        int32 OverrideLevel)
+{
+	if (!AbilitySystem || !AbilitySet)
+	{
+		OnGiven.ExecuteIfBound(FExtendedAbilitySetHandles());
+		return;
+	}
+
+	AbilitySet->GiveToAbilitySystemAsync(AbilitySystem, SourceObject, OverrideLevel,
+	                                     FExtendedAbilitySetGivenDelegate::CreateLambda([OnGiven](const FExtendedAbilitySetHandles& AbilitySetHandles)
+	                                     {
+		                                     OnGiven.ExecuteIfBound(AbilitySetHandles);
+	                                     }));
+}
+
 void UExtendedAbilitySystemStatics::RemoveAbilitySet(UAbilitySystemComponent* AbilitySystem,
                                                      FExtendedAbilitySetHandles& AbilitySetHandles,
                                                      bool bEndImmediately,
@@ -235,9 +286,18 @@ void UExtendedAbilitySystemStatics::AdjustProportionalAttribute(UAttributeSet* A
 		return;
 	}
 
-	const float CurrentValue = GetNumericAttributeBase(AttributeSet, Attribute);
+	AdjustProportionalAttributeBase(AttributeSet, Attribute, GetNumericAttributeBase(AttributeSet, Attribute), OldRelatedValue, NewRelatedValue, bRound, bClamp);
+}
+
+void UExtendedAbilitySystemStatics::AdjustProportionalAttributeBase(UAttributeSet* AttributeSet, const FGameplayAttribute& Attribute, float CurrentBaseValue,
+                                                                    float OldRelatedValue, float NewRelatedValue, bool bRound, bool bClamp)
+{
+	if (!AttributeSet || FMath::IsNearlyEqual(OldRelatedValue, NewRelatedValue))
+	{
+		return;
+	}
 
-	float NewValue = OldRelatedValue > 0.f ? CurrentValue * (NewRelatedValue / OldRelatedValue) : NewRelatedValue;
+	float NewValue = OldRelatedValue > 0.f ? CurrentBaseValue * (NewRelatedValue / OldRelatedValue) : NewRelatedValue;
 
 	if (bRound)
 	{
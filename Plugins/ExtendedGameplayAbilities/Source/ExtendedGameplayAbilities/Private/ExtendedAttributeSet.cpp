@@ -5,18 +5,228 @@
 
 #include "AbilitySystemComponent.h"
 #include "ExtendedAbilitySystemStatics.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/UObjectGlobals.h"
+
+
+namespace ExtendedAttributeSetRules
+{
+	/** Shared rules for each attribute set class. Attribute sets may be created on the async loading thread. */
+	TMap<TObjectKey<UClass>, TSharedRef<const FExtendedAttributeSetRules>> ClassCache;
+	FRWLock ClassCacheLock;
+
+#if WITH_EDITOR
+	FDelegateHandle ObjectsReinstancedHandle;
+#endif
+}
+
+
+TSharedRef<const FExtendedAttributeSetRules> FExtendedAttributeSetRules::Compile(const TMap<FGameplayAttribute, FExtendedMaxAttributeRules>& MaxAttributesMap,
+                                                                                 const TMap<FGameplayAttribute, FFloatRange>& MinMaxValuesMap)
+{
+	TSharedRef<FExtendedAttributeSetRules> NewRules = MakeShared<FExtendedAttributeSetRules>();
+
+	auto GetDataOffset = [](const FGameplayAttribute& Attribute) -> int32
+	{
+		FProperty* Property = Attribute.GetUProperty();
+		return FGameplayAttribute::IsGameplayAttributeDataProperty(Property) ? Property->GetOffset_ForInternal() : INDEX_NONE;
+	};
+
+	auto FindOrAddRules = [&NewRules, &GetDataOffset](const FGameplayAttribute& Attribute) -> FAttributeRules*
+	{
+		const FProperty* Property = Attribute.GetUProperty();
+		if (!Property)
+		{
+			return nullptr;
+		}
+
+		const int32 Slot = Property->GetOffset_ForInternal() / sizeof(float);
+		while (NewRules->RulesIndices.Num() <= Slot)
+		{
+			NewRules->RulesIndices.Add(INDEX_NONE);
+		}
+
+		int16& RulesIdx = NewRules->RulesIndices[Slot];
+		if (RulesIdx == INDEX_NONE)
+		{
+			RulesIdx = static_cast<int16>(NewRules->Rules.AddDefaulted());
+			NewRules->Rules[RulesIdx].Property = Property;
+			NewRules->Rules[RulesIdx].DataOffset = GetDataOffset(Attribute);
+		}
+
+		// attributes from other classes may share an offset, but can't be clamped by this set anyway
+		FAttributeRules& AttributeRules = NewRules->Rules[RulesIdx];
+		return ensure(AttributeRules.Property == Property) ? &AttributeRules : nullptr;
+	};
+
+	for (const TTuple<FGameplayAttribute, FExtendedMaxAttributeRules>& Elem : MaxAttributesMap)
+	{
+		if (FAttributeRules* AttributeRules = FindOrAddRules(Elem.Key))
+		{
+			AttributeRules->MaxAttribute = Elem.Value.MaxAttribute;
+			AttributeRules->MaxAttributeDataOffset = GetDataOffset(Elem.Value.MaxAttribute);
+			AttributeRules->bHasMaxAttribute = true;
+			AttributeRules->bProportional = Elem.Value.bProportional;
+		}
+
+		if (FAttributeRules* MaxAttributeRules = FindOrAddRules(Elem.Value.MaxAttribute))
+		{
+			MaxAttributeRules->DependentAttributes.AddUnique(Elem.Key);
+		}
+	}
+
+	for (const TTuple<FGameplayAttribute, FFloatRange>& Elem : MinMaxValuesMap)
+	{
+		if (FAttributeRules* AttributeRules = FindOrAddRules(Elem.Key))
+		{
+			AttributeRules->bHasValueRange = true;
+			AttributeRules->MinValue = Elem.Value.HasLowerBound() ? Elem.Value.GetLowerBoundValue() : FLT_MIN;
+			AttributeRules->MaxValue = Elem.Value.HasUpperBound() ? Elem.Value.GetUpperBoundValue() : FLT_MAX;
+		}
+	}
+
+	NewRules->Rules.Shrink();
+	NewRules->RulesIndices.Shrink();
+	return NewRules;
+}
+
+TSharedRef<const FExtendedAttributeSetRules> FExtendedAttributeSetRules::GetForClass(const UClass* AttributeSetClass)
+{
+	using namespace ExtendedAttributeSetRules;
+
+	{
+		FReadScopeLock ReadLock(ClassCacheLock);
+		if (const TSharedRef<const FExtendedAttributeSetRules>* ExistingRules = ClassCache.Find(AttributeSetClass))
+		{
+			return *ExistingRules;
+		}
+	}
+
+	const UExtendedAttributeSet* DefaultObject = CastChecked<UExtendedAttributeSet>(AttributeSetClass->GetDefaultObject());
+	TSharedRef<const FExtendedAttributeSetRules> NewRules = Compile(DefaultObject->MaxAttributesMap, DefaultObject->MinMaxValuesMap);
+
+	FWriteScopeLock WriteLock(ClassCacheLock);
+
+#if WITH_EDITOR
+	if (!ObjectsReinstancedHandle.IsValid())
+	{
+		// class defaults may have changed
+		ObjectsReinstancedHandle = FCoreUObjectDelegates::OnObjectsReinstanced.AddLambda([](const FCoreUObjectDelegates::FReplacementObjectMap&)
+		{
+			ClearClassCache();
+		});
+	}
+#endif
+
+	return ClassCache.Emplace(AttributeSetClass, NewRules);
+}
+
+void FExtendedAttributeSetRules::ClearClassCache()
+{
+	using namespace ExtendedAttributeSetRules;
+
+	FWriteScopeLock WriteLock(ClassCacheLock);
+	ClassCache.Reset();
+}
+
+const FExtendedAttributeSetRules& FExtendedAttributeSetRules::GetEmpty()
+{
+	static const FExtendedAttributeSetRules EmptyRules;
+	return EmptyRules;
+}
 
 
 void UExtendedAttributeSet::SetMaxAttribute(const FGameplayAttribute& Attribute, const FGameplayAttribute& MaxAttribute, bool bProportional)
 {
-	FExtendedMaxAttributeRules& Rules = MaxAttributesMap.FindOrAdd(Attribute);
-	Rules.MaxAttribute = MaxAttribute;
-	Rules.bProportional = bProportional;
+	FExtendedMaxAttributeRules& MaxAttributeRules = MaxAttributesMap.FindOrAdd(Attribute);
+	MaxAttributeRules.MaxAttribute = MaxAttribute;
+	MaxAttributeRules.bProportional = bProportional;
+
+	UpdateInstanceRules();
 }
 
 void UExtendedAttributeSet::SetAttributeValueRange(const FGameplayAttribute& Attribute, float Min, float Max)
 {
 	MinMaxValuesMap.Emplace(Attribute, FFloatRange(Min, Max));
+
+	UpdateInstanceRules();
+}
+
+void UExtendedAttributeSet::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (IsTemplate())
+	{
+		// templates keep their maps, and are compiled into shared rules on demand
+		return;
+	}
+
+	// every instance has its own maps, from its constructor or archetype, which decide whether the class rules can be shared
+	UpdateRulesFromMaps();
+}
+
+void UExtendedAttributeSet::PostLoad()
+{
+	Super::PostLoad();
+
+	if (!IsTemplate())
+	{
+		// the rule maps may have been overridden by this instance
+		UpdateRulesFromMaps();
+	}
+}
+
+void UExtendedAttributeSet::PostDuplicate(bool bDuplicateForPIE)
+{
+	Super::PostDuplicate(bDuplicateForPIE);
+
+	if (!IsTemplate())
+	{
+		UpdateRulesFromMaps();
+	}
+}
+
+#if WITH_EDITOR
+void UExtendedAttributeSet::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UExtendedAttributeSet, MaxAttributesMap) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(UExtendedAttributeSet, MinMaxValuesMap))
+	{
+		if (HasAnyFlags(RF_ClassDefaultObject))
+		{
+			FExtendedAttributeSetRules::ClearClassCache();
+		}
+		UpdateInstanceRules();
+	}
+}
+#endif
+
+void UExtendedAttributeSet::UpdateInstanceRules()
+{
+	// before PostInitProperties (e.g. in constructors) the maps are just being setup
+	if (Rules.IsValid())
+	{
+		Rules = FExtendedAttributeSetRules::Compile(MaxAttributesMap, MinMaxValuesMap);
+	}
+}
+
+void UExtendedAttributeSet::UpdateRulesFromMaps()
+{
+	const UExtendedAttributeSet* DefaultObject = GetClass()->GetDefaultObject<UExtendedAttributeSet>();
+	if (MaxAttributesMap.OrderIndependentCompareEqual(DefaultObject->MaxAttributesMap) &&
+		MinMaxValuesMap.OrderIndependentCompareEqual(DefaultObject->MinMaxValuesMap))
+	{
+		// the maps are kept, so that saving or duplicating this set preserves them, only the compiled rules are shared
+		Rules = FExtendedAttributeSetRules::GetForClass(GetClass());
+	}
+	else
+	{
+		Rules = FExtendedAttributeSetRules::Compile(MaxAttributesMap, MinMaxValuesMap);
+	}
 }
 
 void UExtendedAttributeSet::PreAttributeBaseChange(const FGameplayAttribute& Attribute, float& NewValue) const
@@ -42,45 +252,78 @@ void UExtendedAttributeSet::PostAttributeChange(const FGameplayAttribute& Attrib
 
 void UExtendedAttributeSet::ClampAttribute(const FGameplayAttribute& Attribute, float& NewValue) const
 {
-	if (const FExtendedMaxAttributeRules* MaxAttributeRules = MaxAttributesMap.Find(Attribute))
+	const FExtendedAttributeSetRules::FAttributeRules* AttributeRules = GetRules().Find(Attribute);
+	if (!AttributeRules)
+	{
+		return;
+	}
+
+	if (AttributeRules->bHasMaxAttribute)
 	{
-		NewValue = FMath::Clamp(NewValue, 0.f, MaxAttributeRules->MaxAttribute.GetNumericValue(this));
+		const float MaxValue = FExtendedAttributeSetRules::GetCurrentValue(this, AttributeRules->MaxAttribute, AttributeRules->MaxAttributeDataOffset);
+		NewValue = FMath::Clamp(NewValue, 0.f, MaxValue);
 	}
 
-	if (const FFloatRange* MinMaxValues = MinMaxValuesMap.Find(Attribute))
+	if (AttributeRules->bHasValueRange)
 	{
-		const float Min = MinMaxValues->HasLowerBound() ? MinMaxValues->GetLowerBoundValue() : FLT_MIN;
-		const float Max = MinMaxValues->HasUpperBound() ? MinMaxValues->GetUpperBoundValue() : FLT_MAX;
-		NewValue = FMath::Clamp(NewValue, Min, Max);
+		NewValue = FMath::Clamp(NewValue, AttributeRules->MinValue, AttributeRules->MaxValue);
 	}
 }
 
 void UExtendedAttributeSet::AdjustOrClampForMaxAttribute(const FGameplayAttribute& MaxAttribute, float OldMaxValue, float NewMaxValue)
 {
-	for (const TTuple<FGameplayAttribute, FExtendedMaxAttributeRules>& Elem : MaxAttributesMap)
+	const FExtendedAttributeSetRules& AllRules = GetRules();
+	const FExtendedAttributeSetRules::FAttributeRules* MaxAttributeRules = AllRules.Find(MaxAttribute);
+	if (!MaxAttributeRules)
+	{
+		return;
+	}
+
+	for (const FGameplayAttribute& Attribute : MaxAttributeRules->DependentAttributes)
 	{
-		if (Elem.Value.MaxAttribute == MaxAttribute)
+		const FExtendedAttributeSetRules::FAttributeRules* AttributeRules = AllRules.Find(Attribute);
+		if (!AttributeRules)
 		{
-			const FGameplayAttribute& Attribute = Elem.Key;
-			if (Elem.Value.bProportional)
-			{
-				// keep proportional and clamp
-				UExtendedAbilitySystemStatics::AdjustProportionalAttribute(this, Attribute, OldMaxValue, NewMaxValue, false, true);
-			}
-			else
+			continue;
+		}
+
+		const float CurrentValue = FExtendedAttributeSetRules::GetBaseValue(this, Attribute, AttributeRules->DataOffset);
+		if (AttributeRules->bProportional)
+		{
+			// keep proportional and clamp
+			UExtendedAbilitySystemStatics::AdjustProportionalAttributeBase(this, Attribute, CurrentValue, OldMaxValue, NewMaxValue, false, true);
+		}
+		else
+		{
+			// just clamp
+			if (UAbilitySystemComponent* AbilitySystem = GetOwningAbilitySystemComponent())
 			{
-				// just clamp
-				if (UAbilitySystemComponent* AbilitySystem = GetOwningAbilitySystemComponent())
-				{
-					const float CurrentValue = UExtendedAbilitySystemStatics::GetNumericAttributeBase(this, Attribute);
-					const float NewValue = FMath::Min(CurrentValue, NewMaxValue);
-					AbilitySystem->SetNumericAttributeBase(Attribute, NewValue);
-				}
+				const float NewValue = FMath::Min(CurrentValue, NewMaxValue);
+				AbilitySystem->SetNumericAttributeBase(Attribute, NewValue);
 			}
 		}
 	}
 }
 
+void UExtendedAttributeSet::ResetAttributeValues(UAttributeSet* AttributeSet)
+{
+	check(AttributeSet);
+
+	const UObject* Archetype = AttributeSet->GetArchetype();
+	for (TFieldIterator<FStructProperty> It(AttributeSet->GetClass()); It; ++It)
+	{
+		if (FGameplayAttribute::IsGameplayAttributeDataProperty(*It))
+		{
+			It->CopyCompleteValue_InContainer(AttributeSet, Archetype);
+		}
+	}
+
+	if (UExtendedAttributeSet* ExtendedAttributeSet = Cast<UExtendedAttributeSet>(AttributeSet))
+	{
+		ExtendedAttributeSet->ResetRuntimeState();
+	}
+}
+
 void UExtendedAttributeSet::InitAttribute(FGameplayAttributeData& AttributeData, float Value)
 {
 	AttributeData.SetBaseValue(Value);
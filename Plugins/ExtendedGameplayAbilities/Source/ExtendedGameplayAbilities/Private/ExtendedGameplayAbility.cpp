@@ -5,6 +5,8 @@
 
 #include "AbilitySystemGlobals.h"
 #include "AbilitySystemLog.h"
+#include "DataRegistry.h"
+#include "DataRegistrySubsystem.h"
 #include "EnhancedInputSubsystems.h"
 #include "ExtendedAbilitySystemComponent.h"
 #include "ExtendedAbilitySystemStatics.h"
@@ -241,6 +243,13 @@ bool UExtendedGameplayAbility::DoesAbilitySatisfyTagRequirements(const UAbilityS
 	return !bBlocked && !bMissing;
 }
 
+void UExtendedGameplayAbility::OnGiveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec)
+{
+	Super::OnGiveAbility(ActorInfo, Spec);
+
+	PrefetchAbilityStats();
+}
+
 void UExtendedGameplayAbility::OnAvatarSet(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec)
 {
 	Super::OnAvatarSet(ActorInfo, Spec);
@@ -334,8 +343,72 @@ TArray<FActiveGameplayEffectHandle> UExtendedGameplayAbility::ApplyEffectSpecSet
 
 float UExtendedGameplayAbility::GetAbilityStat(FDataRegistryId Id, float DefaultValue) const
 {
-	const float InputValue = static_cast<float>(GetAbilityLevel());
-	return UExtendedAbilitySystemStatics::GetDataRegistryValue(Id, InputValue, DefaultValue);
+	const int32 AbilityLevel = GetAbilityLevel();
+	if (!IsInstantiated())
+	{
+		// non-instanced abilities are shared by all ability systems, don't cache anything
+		return UExtendedAbilitySystemStatics::GetDataRegistryValue(Id, static_cast<float>(AbilityLevel), DefaultValue);
+	}
+
+	const FExtendedCachedAbilityStat* CachedStat = FindOrCacheAbilityStat(Id, AbilityLevel);
+	return CachedStat ? CachedStat->Value : DefaultValue;
+}
+
+void UExtendedGameplayAbility::PrefetchAbilityStats() const
+{
+	if (!IsInstantiated() || AbilityStatIds.IsEmpty())
+	{
+		return;
+	}
+
+	const int32 AbilityLevel = GetAbilityLevel();
+	for (const FDataRegistryId& Id : AbilityStatIds)
+	{
+		FindOrCacheAbilityStat(Id, AbilityLevel);
+	}
+}
+
+void UExtendedGameplayAbility::ClearAbilityStatCache() const
+{
+	CachedAbilityStats.Reset();
+	CachedAbilityStatsLevel = INDEX_NONE;
+}
+
+const FExtendedCachedAbilityStat* UExtendedGameplayAbility::FindOrCacheAbilityStat(const FDataRegistryId& Id, int32 AbilityLevel) const
+{
+	if (CachedAbilityStatsLevel != AbilityLevel)
+	{
+		CachedAbilityStats.Reset();
+		CachedAbilityStatsLevel = AbilityLevel;
+	}
+
+	if (const FExtendedCachedAbilityStat* CachedStat = CachedAbilityStats.Find(Id))
+	{
+		const UDataRegistry* Registry = CachedStat->Registry.Get();
+		if (Registry && Registry->GetCacheVersion() == CachedStat->CacheVersion)
+		{
+			return CachedStat;
+		}
+	}
+
+	const UDataRegistrySubsystem* DataRegistrySubsystem = UDataRegistrySubsystem::Get();
+
+	float Value;
+	const FRealCurve* FoundCurve = nullptr;
+	if (!DataRegistrySubsystem->EvaluateCachedCurve(Value, FoundCurve, Id, static_cast<float>(AbilityLevel)))
+	{
+		// don't cache missing values, the item may not be loaded yet
+		CachedAbilityStats.Remove(Id);
+		return nullptr;
+	}
+
+	const UDataRegistry* Registry = DataRegistrySubsystem->GetRegistryForType(Id.RegistryType);
+
+	FExtendedCachedAbilityStat& NewStat = CachedAbilityStats.FindOrAdd(Id);
+	NewStat.Value = Value;
+	NewStat.Registry = Registry;
+	NewStat.CacheVersion = Registry ? Registry->GetCacheVersion() : INDEX_NONE;
+	return &NewStat;
 }
 
 APawn* UExtendedGameplayAbility::GetPawnFromActorInfo() const
@@ -6,13 +6,16 @@
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
 #include "AbilitySystemLog.h"
-#include "AbilitySystemStats.h"
 #include "ExtendedAbilitySystemStatics.h"
+#include "ExtendedGameplayAbilitiesModule.h"
 #include "TimerManager.h"
 #include "Engine/World.h"
 #include "Stats/Stats.h"
 
 
+DECLARE_CYCLE_STAT(TEXT("HandleGameplayCue (Extended Looping)"), STAT_ExtendedGameplayCueNotifyLooping_HandleGameplayCue, STATGROUP_ExtendedGameplayAbilities);
+
+
 AExtendedGameplayCueNotify_Looping::AExtendedGameplayCueNotify_Looping()
 {
 }
@@ -25,14 +28,21 @@ TArray<FActiveGameplayEffectHandle> AExtendedGameplayCueNotify_Looping::GetGrant
 
 void AExtendedGameplayCueNotify_Looping::HandleGameplayCue(AActor* MyTarget, EGameplayCueEvent::Type EventType, const FGameplayCueParameters& Parameters)
 {
-	// TODO: find out why linker error occurs when this is enabled
-	// SCOPE_CYCLE_COUNTER(STAT_HandleGameplayCueNotifyActor);
+	// STAT_HandleGameplayCueNotifyActor isn't exported from GameplayAbilities, so use our own
+	SCOPE_CYCLE_COUNTER(STAT_ExtendedGameplayCueNotifyLooping_HandleGameplayCue);
 
 	if (Parameters.MatchedTagName.IsValid() == false)
 	{
 		ABILITY_LOG(Warning, TEXT("GameplayCue parameter is none for %s"), *GetNameSafe(this));
 	}
 
+	// If the cue is added again after OnRemove, but before the actor has finished and been recycled,
+	// reuse it as is by cancelling the pending finish and resetting the handled event state.
+	if (bHasHandledOnRemoveEvent && (EventType == EGameplayCueEvent::OnActive || EventType == EGameplayCueEvent::WhileActive))
+	{
+		ReviveAfterRemove();
+	}
+
 	// Handle multiple event gating
 	{
 		if (EventType == EGameplayCueEvent::OnActive && !bAllowMultipleOnActiveEvents && bHasHandledOnActiveEvent)
@@ -121,6 +131,18 @@ void AExtendedGameplayCueNotify_Looping::HandleGameplayCue(AActor* MyTarget, EGa
 	}
 }
 
+void AExtendedGameplayCueNotify_Looping::ReviveAfterRemove()
+{
+	if (FinishTimerHandle.IsValid())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(FinishTimerHandle);
+	}
+
+	bHasHandledOnActiveEvent = false;
+	bHasHandledWhileActiveEvent = false;
+	bHasHandledOnRemoveEvent = false;
+}
+
 bool AExtendedGameplayCueNotify_Looping::WhileActive_Implementation(AActor* MyTarget, const FGameplayCueParameters& Parameters)
 {
 	// AGameplayCueNotify_Actor does this, but Looping doesn't call the super implementation.
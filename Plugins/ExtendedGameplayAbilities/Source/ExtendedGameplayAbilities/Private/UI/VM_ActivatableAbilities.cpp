@@ -4,6 +4,7 @@
 #include "UI/VM_ActivatableAbilities.h"
 
 #include "AbilitySystemComponent.h"
+#include "ExtendedAbilitySet.h"
 #include "ExtendedAbilitySystemComponent.h"
 #include "Logging/MessageLog.h"
 #include "UI/VM_GameplayAbility.h"
@@ -19,6 +20,7 @@ void UVM_ActivatableAbilities::PreSystemChange()
 	if (UExtendedAbilitySystemComponent* ASC = GetAbilitySystem<UExtendedAbilitySystemComponent>())
 	{
 		ASC->OnGiveAbilityEvent.RemoveAll(this);
+		ASC->OnAbilitySetGrantedEvent.RemoveAll(this);
 		ASC->OnRemoveAbilityEvent.RemoveAll(this);
 	}
 
@@ -30,6 +32,7 @@ void UVM_ActivatableAbilities::PostSystemChange()
 	if (UExtendedAbilitySystemComponent* ASC = GetAbilitySystem<UExtendedAbilitySystemComponent>())
 	{
 		ASC->OnGiveAbilityEvent.AddUObject(this, &UVM_ActivatableAbilities::OnGiveAbility);
+		ASC->OnAbilitySetGrantedEvent.AddUObject(this, &UVM_ActivatableAbilities::OnAbilitySetGranted);
 		ASC->OnRemoveAbilityEvent.AddUObject(this, &UVM_ActivatableAbilities::OnRemoveAbility);
 	}
 
@@ -147,6 +150,18 @@ void UVM_ActivatableAbilities::OnGiveAbility(FGameplayAbilitySpec& GameplayAbili
 	OnAbilitiesChangedEvent.Broadcast();
 }
 
+void UVM_ActivatableAbilities::OnAbilitySetGranted(const FExtendedAbilitySetHandles& AbilitySetHandles)
+{
+	if (AbilitySetHandles.AbilitySpecHandles.IsEmpty())
+	{
+		return;
+	}
+
+	UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetAbilitySpecHandles);
+	UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetAbilityViewModels);
+	OnAbilitiesChangedEvent.Broadcast();
+}
+
 void UVM_ActivatableAbilities::OnRemoveAbility(FGameplayAbilitySpec& GameplayAbilitySpec)
 {
 	AbilityBeingRemoved = GameplayAbilitySpec.Handle;
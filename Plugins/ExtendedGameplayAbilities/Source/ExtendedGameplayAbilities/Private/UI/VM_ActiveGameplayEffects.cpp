@@ -22,52 +22,108 @@ void UVM_ActiveGameplayEffects::SetRequiredUIDataClass(TSubclassOf<UGameplayEffe
 	if (RequiredUIDataClass != NewRequireUIDataClass)
 	{
 		RequiredUIDataClass = NewRequireUIDataClass;
+		HasRequiredUIDataCache.Reset();
 
 		UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(RequiredUIDataClass);
-		UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetActiveEffects);
-		UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetActiveEffectViewModels);
+		InvalidateActiveEffects();
 	}
 }
 
-TArray<FActiveGameplayEffectHandle> UVM_ActiveGameplayEffects::GetActiveEffects() const
+const TArray<FActiveGameplayEffectHandle>& UVM_ActiveGameplayEffects::GetActiveEffects() const
 {
-	TArray<FActiveGameplayEffectHandle> Result;
-	if (AbilitySystem.IsValid())
+	if (bActiveEffectsDirty)
 	{
-		for (FActiveGameplayEffectsContainer::ConstIterator EffectIt = AbilitySystem->GetActiveGameplayEffects().CreateConstIterator(); EffectIt; ++EffectIt)
+		ActiveEffects.Reset();
+		if (AbilitySystem.IsValid())
 		{
-			const FActiveGameplayEffect& Effect = *EffectIt;
-			if (!EffectQuery.Matches(Effect))
-			{
-				continue;
-			}
-			if (RequiredUIDataClass && (!Effect.Spec.Def || !Effect.Spec.Def->FindComponent(RequiredUIDataClass)))
+			for (FActiveGameplayEffectsContainer::ConstIterator EffectIt = AbilitySystem->GetActiveGameplayEffects().CreateConstIterator(); EffectIt; ++EffectIt)
 			{
-				continue;
+				const FActiveGameplayEffect& Effect = *EffectIt;
+				if (!Effect.IsPendingRemove && ShouldIncludeEffect(Effect))
+				{
+					ActiveEffects.Add(Effect.Handle);
+				}
 			}
-			Result.Add(Effect.Handle);
 		}
+		bActiveEffectsDirty = false;
+		bViewModelsDirty = true;
 	}
-	return Result;
+	return ActiveEffects;
 }
 
-TArray<UVM_ActiveGameplayEffect*> UVM_ActiveGameplayEffects::GetActiveEffectViewModels() const
+const TArray<UVM_ActiveGameplayEffect*>& UVM_ActiveGameplayEffects::GetActiveEffectViewModels() const
 {
-	TArray<UVM_ActiveGameplayEffect*> Result;
-	TArray<FActiveGameplayEffectHandle> ActiveEffects = GetActiveEffects();
-	if (!ActiveEffects.IsEmpty())
+	const TArray<FActiveGameplayEffectHandle>& Handles = GetActiveEffects();
+	if (bViewModelsDirty)
 	{
 		UVM_ActiveGameplayEffects* MutableThis = const_cast<UVM_ActiveGameplayEffects*>(this);
 
-		Result.Reserve(ActiveEffects.Num());
-		for (const FActiveGameplayEffectHandle& ActiveEffect : ActiveEffects)
+		TMap<FActiveGameplayEffectHandle, TObjectPtr<UVM_ActiveGameplayEffect>> NewViewModelsByHandle;
+		NewViewModelsByHandle.Reserve(Handles.Num());
+		ActiveEffectViewModels.Reset(Handles.Num());
+		for (const FActiveGameplayEffectHandle& ActiveEffect : Handles)
 		{
-			UVM_ActiveGameplayEffect* EffectViewModel = NewObject<UVM_ActiveGameplayEffect>(MutableThis, NAME_None, RF_Transient);
-			EffectViewModel->SetActiveEffectHandle(ActiveEffect);
-			Result.Add(EffectViewModel);
+			// reuse the existing view model for this effect if there is one
+			UVM_ActiveGameplayEffect* EffectViewModel = ViewModelsByHandle.FindRef(ActiveEffect);
+			if (!EffectViewModel)
+			{
+				EffectViewModel = NewObject<UVM_ActiveGameplayEffect>(MutableThis, NAME_None, RF_Transient);
+				EffectViewModel->SetActiveEffectHandle(ActiveEffect);
+			}
+
+			NewViewModelsByHandle.Add(ActiveEffect, EffectViewModel);
+			ActiveEffectViewModels.Add(EffectViewModel);
 		}
+
+		ViewModelsByHandle = MoveTemp(NewViewModelsByHandle);
+		bViewModelsDirty = false;
+	}
+	return ActiveEffectViewModels;
+}
+
+bool UVM_ActiveGameplayEffects::ShouldIncludeEffect(const FActiveGameplayEffect& ActiveEffect) const
+{
+	if (!EffectQuery.Matches(ActiveEffect))
+	{
+		return false;
+	}
+	if (RequiredUIDataClass && !HasRequiredUIData(ActiveEffect.Spec.Def))
+	{
+		return false;
+	}
+	return true;
+}
+
+bool UVM_ActiveGameplayEffects::HasRequiredUIData(const UGameplayEffect* EffectDef) const
+{
+	if (!EffectDef)
+	{
+		return false;
 	}
-	return Result;
+
+	const TObjectKey<UGameplayEffect> EffectKey(EffectDef);
+	if (const bool* bCachedResult = HasRequiredUIDataCache.Find(EffectKey))
+	{
+		return *bCachedResult;
+	}
+
+	const bool bResult = EffectDef->FindComponent(RequiredUIDataClass) != nullptr;
+	HasRequiredUIDataCache.Add(EffectKey, bResult);
+	return bResult;
+}
+
+void UVM_ActiveGameplayEffects::InvalidateActiveEffects()
+{
+	bActiveEffectsDirty = true;
+	bViewModelsDirty = true;
+
+	BroadcastActiveEffectsChanged();
+}
+
+void UVM_ActiveGameplayEffects::BroadcastActiveEffectsChanged()
+{
+	UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetActiveEffects);
+	UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetActiveEffectViewModels);
 }
 
 void UVM_ActiveGameplayEffects::PreSystemChange()
@@ -91,8 +147,7 @@ void UVM_ActiveGameplayEffects::PostSystemChange()
 
 	Super::PostSystemChange();
 
-	UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetActiveEffects);
-	UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetActiveEffectViewModels);
+	InvalidateActiveEffects();
 }
 
 void UVM_ActiveGameplayEffects::OnActiveGameplayEffectAdded(UAbilitySystemComponent* AbilitySystemComponent,
@@ -102,19 +157,30 @@ void UVM_ActiveGameplayEffects::OnActiveGameplayEffectAdded(UAbilitySystemCompon
 	if (AbilitySystem.IsValid())
 	{
 		const FActiveGameplayEffect* ActiveEffect = AbilitySystem->GetActiveGameplayEffect(ActiveGameplayEffectHandle);
-		if (ActiveEffect && EffectQuery.Matches(*ActiveEffect))
+		if (ActiveEffect && ShouldIncludeEffect(*ActiveEffect))
 		{
-			UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetActiveEffects);
-			UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetActiveEffectViewModels);
+			// update the cached list in place, if it's already been built
+			if (!bActiveEffectsDirty)
+			{
+				ActiveEffects.AddUnique(ActiveGameplayEffectHandle);
+			}
+			bViewModelsDirty = true;
+
+			BroadcastActiveEffectsChanged();
 		}
 	}
 }
 
 void UVM_ActiveGameplayEffects::OnAnyGameplayEffectRemoved(const FActiveGameplayEffect& ActiveGameplayEffect)
 {
-	if (EffectQuery.Matches(ActiveGameplayEffect))
+	// the effect may not be fully removed from the ability system yet, so remove it from the cached list explicitly
+	const bool bWasIncluded = bActiveEffectsDirty
+		                          ? ShouldIncludeEffect(ActiveGameplayEffect)
+		                          : ActiveEffects.RemoveSingle(ActiveGameplayEffect.Handle) > 0;
+	if (bWasIncluded)
 	{
-		UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetActiveEffects);
-		UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetActiveEffectViewModels);
+		bViewModelsDirty = true;
+
+		BroadcastActiveEffectsChanged();
 	}
 }
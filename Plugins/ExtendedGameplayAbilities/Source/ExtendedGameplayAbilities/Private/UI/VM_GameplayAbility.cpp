@@ -4,6 +4,79 @@
 #include "UI/VM_GameplayAbility.h"
 
 #include "AbilitySystemComponent.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/UObjectGlobals.h"
+
+
+namespace GameplayAbilityClassViewInfo
+{
+	TMap<TObjectKey<UClass>, TSharedRef<const FGameplayAbilityClassViewInfo>> Cache;
+
+#if WITH_EDITOR
+	FDelegateHandle ObjectsReinstancedHandle;
+#endif
+}
+
+TSharedRef<const FGameplayAbilityClassViewInfo> FGameplayAbilityClassViewInfo::Get(const UGameplayAbility* AbilityCDO)
+{
+	check(AbilityCDO);
+	check(IsInGameThread());
+
+	const TObjectKey<UClass> ClassKey(AbilityCDO->GetClass());
+	if (const TSharedRef<const FGameplayAbilityClassViewInfo>* ExistingInfo = GameplayAbilityClassViewInfo::Cache.Find(ClassKey))
+	{
+		return *ExistingInfo;
+	}
+
+#if WITH_EDITOR
+	// recompiling an ability or its cost effect can change the info, so start over when that happens
+	if (!GameplayAbilityClassViewInfo::ObjectsReinstancedHandle.IsValid())
+	{
+		GameplayAbilityClassViewInfo::ObjectsReinstancedHandle = FCoreUObjectDelegates::OnObjectsReinstanced.AddLambda(
+			[](const TMap<UObject*, UObject*>&)
+			{
+				ClearCache();
+			});
+	}
+#endif
+
+	const TSharedRef<FGameplayAbilityClassViewInfo> NewInfo = MakeShared<FGameplayAbilityClassViewInfo>();
+
+	if (const FGameplayTagContainer* CooldownTags = AbilityCDO->GetCooldownTags())
+	{
+		NewInfo->CooldownTags = *CooldownTags;
+	}
+	if (!NewInfo->CooldownTags.IsEmpty())
+	{
+		NewInfo->CooldownEffectQuery = FGameplayEffectQuery::MakeQuery_MatchAnyOwningTags(NewInfo->CooldownTags);
+	}
+
+	if (const UGameplayEffect* CostGE = AbilityCDO->GetCostGameplayEffect())
+	{
+		for (const FGameplayModifierInfo& Modifier : CostGE->Modifiers)
+		{
+			if (Modifier.Attribute.IsValid())
+			{
+				NewInfo->CostAttributes.AddUnique(Modifier.Attribute);
+			}
+		}
+	}
+
+	GameplayAbilityClassViewInfo::Cache.Add(ClassKey, NewInfo);
+	return NewInfo;
+}
+
+const FGameplayAbilityClassViewInfo& FGameplayAbilityClassViewInfo::GetEmpty()
+{
+	static const FGameplayAbilityClassViewInfo EmptyInfo;
+	return EmptyInfo;
+}
+
+void FGameplayAbilityClassViewInfo::ClearCache()
+{
+	// view models keep their shared info alive until they are rebound
+	GameplayAbilityClassViewInfo::Cache.Reset();
+}
 
 
 void UVM_GameplayAbility::SetAbilitySpecHandle(FGameplayAbilitySpecHandle NewAbilitySpecHandle)
@@ -43,6 +116,7 @@ void UVM_GameplayAbility::PreSystemChange()
 	}
 	RegisteredCostAttributes.Reset();
 	RegisteredCooldownTags.Reset();
+	AbilityClassViewInfo.Reset();
 
 	Super::PreSystemChange();
 }
@@ -62,7 +136,7 @@ void UVM_GameplayAbility::PostSystemChange()
 
 		// listen for cost attribute changes for CanActivate
 		RegisteredCostAttributes = GetCostAttributes();
-		for (const FGameplayAttribute& Attribute : GetCostAttributes())
+		for (const FGameplayAttribute& Attribute : RegisteredCostAttributes)
 		{
 			ASC->GetGameplayAttributeValueChangeDelegate(Attribute).AddUObject(this, &UVM_GameplayAbility::OnCostAttributeChanged);
 		}
@@ -129,7 +203,7 @@ bool UVM_GameplayAbility::IsOnCooldown() const
 {
 	if (AbilitySystem.IsValid())
 	{
-		const FGameplayTagContainer CooldownTags = GetCooldownTags();
+		const FGameplayTagContainer& CooldownTags = GetCooldownTags();
 		if (!CooldownTags.IsEmpty())
 		{
 			return AbilitySystem->HasAnyMatchingGameplayTags(CooldownTags);
@@ -138,53 +212,28 @@ bool UVM_GameplayAbility::IsOnCooldown() const
 	return false;
 }
 
-FGameplayTagContainer UVM_GameplayAbility::GetCooldownTags() const
+const FGameplayTagContainer& UVM_GameplayAbility::GetCooldownTags() const
 {
-	const FGameplayAbilitySpec* AbilitySpec = GetAbilitySpec();
-	if (AbilitySpec && AbilitySpec->Ability)
-	{
-		if (const FGameplayTagContainer* CooldownTags = AbilitySpec->Ability->GetCooldownTags())
-		{
-			return *CooldownTags;
-		}
-	}
-	return FGameplayTagContainer();
+	return GetAbilityClassViewInfo().CooldownTags;
 }
 
-TArray<FGameplayAttribute> UVM_GameplayAbility::GetCostAttributes() const
+const TArray<FGameplayAttribute>& UVM_GameplayAbility::GetCostAttributes() const
 {
-	TArray<FGameplayAttribute> Result;
-	const FGameplayAbilitySpec* AbilitySpec = GetAbilitySpec();
-	if (AbilitySpec && AbilitySpec->Ability)
-	{
-		if (UGameplayEffect* CostGE = AbilitySpec->Ability->GetCostGameplayEffect())
-		{
-			for (const FGameplayModifierInfo& Modifier : CostGE->Modifiers)
-			{
-				if (Modifier.Attribute.IsValid())
-				{
-					Result.Add(Modifier.Attribute);
-				}
-			}
-		}
-	}
-	return Result;
+	return GetAbilityClassViewInfo().CostAttributes;
 }
 
 FActiveGameplayEffectHandle UVM_GameplayAbility::GetActiveCooldownEffect() const
 {
-	const FGameplayTagContainer CooldownTags = GetCooldownTags();
-	if (!CooldownTags.IsEmpty())
+	const FGameplayAbilityClassViewInfo& ClassViewInfo = GetAbilityClassViewInfo();
+	if (AbilitySystem.IsValid() && !ClassViewInfo.CooldownTags.IsEmpty())
 	{
-		const FGameplayEffectQuery Query = FGameplayEffectQuery::MakeQuery_MatchAnyOwningTags(CooldownTags);
-
 		FActiveGameplayEffectHandle BestEffect;
 		float BestEndTime = 0.f;
 
 		for (FActiveGameplayEffectsContainer::ConstIterator EffectIt = AbilitySystem->GetActiveGameplayEffects().CreateConstIterator(); EffectIt; ++EffectIt)
 		{
 			const FActiveGameplayEffect& Effect = *EffectIt;
-			if (Query.Matches(Effect))
+			if (ClassViewInfo.CooldownEffectQuery.Matches(Effect))
 			{
 				const float EndTime = Effect.GetEndTime();
 				if (!BestEffect.IsValid() || EndTime > BestEndTime)
@@ -226,6 +275,20 @@ FGameplayAbilitySpec* UVM_GameplayAbility::GetAbilitySpec() const
 	return nullptr;
 }
 
+const FGameplayAbilityClassViewInfo& UVM_GameplayAbility::GetAbilityClassViewInfo() const
+{
+	if (!AbilityClassViewInfo.IsValid())
+	{
+		const FGameplayAbilitySpec* AbilitySpec = GetAbilitySpec();
+		if (!AbilitySpec || !AbilitySpec->Ability)
+		{
+			return FGameplayAbilityClassViewInfo::GetEmpty();
+		}
+		AbilityClassViewInfo = FGameplayAbilityClassViewInfo::Get(AbilitySpec->Ability);
+	}
+	return *AbilityClassViewInfo;
+}
+
 void UVM_GameplayAbility::OnAnyAbilityActivated(UGameplayAbility* GameplayAbility)
 {
 	if (GameplayAbility->GetClass() == GetAbilityClass())
@@ -4,6 +4,7 @@
 #include "UI/VM_GameplayAttribute.h"
 
 #include "AbilitySystemComponent.h"
+#include "ExtendedAbilitySystemComponent.h"
 
 
 void UVM_GameplayAttribute::SetAttribute(FGameplayAttribute NewAttribute)
@@ -27,8 +28,16 @@ void UVM_GameplayAttribute::PreSystemChange()
 	if (AbilitySystem.IsValid() && Attribute.IsValid())
 	{
 		AbilitySystem->GetGameplayAttributeValueChangeDelegate(Attribute).RemoveAll(this);
+
+		if (UExtendedAbilitySystemComponent* ExtendedAbilitySystem = Cast<UExtendedAbilitySystemComponent>(AbilitySystem.Get()))
+		{
+			ExtendedAbilitySystem->OnAttributeSetsChangedEvent.RemoveAll(this);
+		}
 	}
 
+	CachedValue = 0.f;
+	bHasCachedValue = false;
+
 	Super::PreSystemChange();
 }
 
@@ -37,6 +46,14 @@ void UVM_GameplayAttribute::PostSystemChange()
 	if (AbilitySystem.IsValid() && Attribute.IsValid())
 	{
 		AbilitySystem->GetGameplayAttributeValueChangeDelegate(Attribute).AddUObject(this, &UVM_GameplayAttribute::OnAttributeValueChanged);
+
+		// the attribute set may be added or removed after binding, e.g. by ability sets
+		if (UExtendedAbilitySystemComponent* ExtendedAbilitySystem = Cast<UExtendedAbilitySystemComponent>(AbilitySystem.Get()))
+		{
+			ExtendedAbilitySystem->OnAttributeSetsChangedEvent.AddUObject(this, &UVM_GameplayAttribute::OnAttributeSetsChanged);
+		}
+
+		UpdateCachedValue();
 	}
 
 	Super::PostSystemChange();
@@ -48,22 +65,49 @@ void UVM_GameplayAttribute::PostSystemChange()
 
 float UVM_GameplayAttribute::GetValue() const
 {
-	if (AbilitySystem.IsValid())
+	if (!bHasCachedValue)
+	{
+		// the attribute set may not have been added yet when bound, keep trying until it's found
+		UpdateCachedValue();
+	}
+	return CachedValue;
+}
+
+void UVM_GameplayAttribute::UpdateCachedValue() const
+{
+	if (AbilitySystem.IsValid() && Attribute.IsValid())
 	{
 		bool bFound;
 		const float Value = AbilitySystem->GetGameplayAttributeValue(Attribute, bFound);
-		if (bFound)
-		{
-			return Value;
-		}
+		CachedValue = bFound ? Value : 0.f;
+
+		// extended ability systems report when attribute sets change, so a missing attribute doesn't need to be looked up again until then
+		bHasCachedValue = bFound || AbilitySystem->IsA<UExtendedAbilitySystemComponent>();
+		return;
+	}
+	CachedValue = 0.f;
+	bHasCachedValue = false;
+}
+
+void UVM_GameplayAttribute::OnAttributeSetsChanged()
+{
+	const float OldValue = CachedValue;
+	const bool bHadCachedValue = bHasCachedValue;
+	UpdateCachedValue();
+
+	if (!bHadCachedValue || CachedValue != OldValue)
+	{
+		UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetValue);
 	}
-	return 0.f;
 }
 
 void UVM_GameplayAttribute::OnAttributeValueChanged(const FOnAttributeChangeData& ChangeData)
 {
 	if (ChangeData.Attribute == Attribute)
 	{
+		CachedValue = ChangeData.NewValue;
+		bHasCachedValue = true;
+
 		UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetValue);
 	}
 }
@@ -0,0 +1,133 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "UI/VM_GameplayAttributes.h"
+
+#include "AbilitySystemComponent.h"
+#include "ExtendedAbilitySystemComponent.h"
+
+
+void UVM_GameplayAttributes::SetAttributes(const TArray<FGameplayAttribute>& NewAttributes)
+{
+	SetAbilitySystemAndAttributes(AbilitySystem.Get(), NewAttributes);
+}
+
+void UVM_GameplayAttributes::SetAbilitySystemAndAttributes(UAbilitySystemComponent* NewAbilitySystem, const TArray<FGameplayAttribute>& NewAttributes)
+{
+	if (AbilitySystem.Get() != NewAbilitySystem || Attributes != NewAttributes)
+	{
+		PreSystemChange();
+		Attributes = NewAttributes;
+		AbilitySystem = NewAbilitySystem;
+		PostSystemChange();
+	}
+}
+
+float UVM_GameplayAttributes::GetValueAt(int32 Index) const
+{
+	return Values.IsValidIndex(Index) ? Values[Index] : 0.f;
+}
+
+float UVM_GameplayAttributes::GetAttributeValue(FGameplayAttribute InAttribute) const
+{
+	return GetValueAt(Attributes.IndexOfByKey(InAttribute));
+}
+
+void UVM_GameplayAttributes::UpdateValues()
+{
+	Values.SetNumZeroed(Attributes.Num());
+
+	if (AbilitySystem.IsValid())
+	{
+		for (int32 Idx = 0; Idx < Attributes.Num(); ++Idx)
+		{
+			bool bFound;
+			const float Value = AbilitySystem->GetGameplayAttributeValue(Attributes[Idx], bFound);
+			Values[Idx] = bFound ? Value : 0.f;
+		}
+	}
+}
+
+void UVM_GameplayAttributes::PreSystemChange()
+{
+	if (AbilitySystem.IsValid())
+	{
+		for (const FGameplayAttribute& Attribute : Attributes)
+		{
+			if (Attribute.IsValid())
+			{
+				AbilitySystem->GetGameplayAttributeValueChangeDelegate(Attribute).RemoveAll(this);
+			}
+		}
+
+		if (UExtendedAbilitySystemComponent* ExtendedAbilitySystem = Cast<UExtendedAbilitySystemComponent>(AbilitySystem.Get()))
+		{
+			ExtendedAbilitySystem->OnAttributeSetsChangedEvent.RemoveAll(this);
+		}
+	}
+
+	Super::PreSystemChange();
+}
+
+void UVM_GameplayAttributes::PostSystemChange()
+{
+	if (AbilitySystem.IsValid())
+	{
+		for (const FGameplayAttribute& Attribute : Attributes)
+		{
+			if (Attribute.IsValid())
+			{
+				// avoid binding twice if an attribute is listed more than once
+				FOnGameplayAttributeValueChange& Delegate = AbilitySystem->GetGameplayAttributeValueChangeDelegate(Attribute);
+				if (!Delegate.IsBoundToObject(this))
+				{
+					Delegate.AddUObject(this, &UVM_GameplayAttributes::OnAttributeValueChanged);
+				}
+			}
+		}
+
+		// attribute sets may be granted after binding, e.g. by ability sets
+		if (UExtendedAbilitySystemComponent* ExtendedAbilitySystem = Cast<UExtendedAbilitySystemComponent>(AbilitySystem.Get()))
+		{
+			ExtendedAbilitySystem->OnAttributeSetsChangedEvent.AddUObject(this, &UVM_GameplayAttributes::OnAttributeSetsChanged);
+		}
+	}
+
+	UpdateValues();
+
+	Super::PostSystemChange();
+
+	UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(Attributes);
+
+	UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetValues);
+}
+
+void UVM_GameplayAttributes::OnAttributeValueChanged(const FOnAttributeChangeData& ChangeData)
+{
+	bool bChanged = false;
+	for (int32 Idx = 0; Idx < Attributes.Num(); ++Idx)
+	{
+		if (Attributes[Idx] == ChangeData.Attribute)
+		{
+			Values[Idx] = ChangeData.NewValue;
+			bChanged = true;
+		}
+	}
+
+	if (bChanged)
+	{
+		UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetValues);
+	}
+}
+
+void UVM_GameplayAttributes::OnAttributeSetsChanged()
+{
+	// attribute sets change rarely, so just update everything, clearing the values of any removed sets
+	const TArray<float> OldValues = Values;
+	UpdateValues();
+
+	if (Values != OldValues)
+	{
+		UE_MVVM_BROADCAST_FIELD_VALUE_CHANGED(GetValues);
+	}
+}
@@ -0,0 +1,138 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayAbilitySpecHandle.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "BTAbilityTaskSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+class UBehaviorTreeComponent;
+class UBTTask_ActivateAbility;
+struct FAbilityEndedData;
+
+
+/** Latency metrics for abilities activated from the activation queue of a UBTAbilityTaskSubsystem. */
+struct FBTAbilityActivationQueueMetrics
+{
+	/** The total number of queued abilities that were activated. */
+	int64 NumActivations = 0;
+
+	/** The total number of seconds that activated abilities were queued. */
+	double TotalLatency = 0.0;
+
+	/** The longest number of seconds that an activated ability was queued. */
+	double MaxLatency = 0.0;
+
+	/** The most frames that an activated ability was queued. */
+	int32 MaxFramesQueued = 0;
+
+	/** Return the average number of seconds that activated abilities were queued. */
+	double GetAverageLatency() const { return NumActivations > 0 ? TotalLatency / NumActivations : 0.0; }
+};
+
+
+/**
+ * Shared state for ability behavior tree tasks, so that tasks don't need to be instanced per behavior tree.
+ * Binds to the ability ended event once per ability system, and routes it to whichever tasks are waiting for that ability.
+ *
+ * Also limits the number of abilities that tasks activate each frame when AIAbilityActivationsPerFrame is set,
+ * so that many AI deciding to activate abilities at once are spread across frames.
+ */
+UCLASS()
+class EXTENDEDGAMEPLAYABILITIES_API UBTAbilityTaskSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Return true if abilities activated by tasks should be queued, instead of activated immediately. */
+	bool ShouldQueueAbilityActivations() const;
+
+	/** Queue an ability to be activated by a task in this or a later frame. */
+	void QueueAbilityActivation(UAbilitySystemComponent* AbilitySystem, FGameplayAbilitySpecHandle SpecHandle,
+	                            UBehaviorTreeComponent& OwnerComp, const UBTTask_ActivateAbility* Task);
+
+	/** Remove a queued ability activation for a task, e.g. when it is aborted. */
+	void CancelQueuedAbilityActivation(const UBehaviorTreeComponent& OwnerComp, const UBTTask_ActivateAbility* Task);
+
+	/** Return true if a task has an ability activation waiting in the queue. */
+	bool IsAbilityActivationQueued(const UBehaviorTreeComponent& OwnerComp, const UBTTask_ActivateAbility* Task) const;
+
+	/** Return the number of ability activations waiting in the queue. */
+	int32 GetNumQueuedAbilityActivations() const { return QueuedActivations.Num(); }
+
+	/** Return latency metrics for all abilities activated from the queue. */
+	const FBTAbilityActivationQueueMetrics& GetActivationQueueMetrics() const { return ActivationQueueMetrics; }
+
+	/** Reset latency metrics for abilities activated from the queue. */
+	void ResetActivationQueueMetrics();
+
+	/** Notify a task when an ability ends, until it is removed with RemoveWaitingTask. */
+	void AddWaitingTask(UAbilitySystemComponent* AbilitySystem, FGameplayAbilitySpecHandle SpecHandle,
+	                    UBehaviorTreeComponent& OwnerComp, const UBTTask_ActivateAbility* Task);
+
+	/** Stop notifying a task about an ability system. */
+	void RemoveWaitingTask(TObjectKey<UAbilitySystemComponent> AbilitySystemKey, const UBehaviorTreeComponent& OwnerComp, const UBTTask_ActivateAbility* Task);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	struct FWaitingTask
+	{
+		FGameplayAbilitySpecHandle SpecHandle;
+		TWeakObjectPtr<UBehaviorTreeComponent> OwnerComp;
+		TWeakObjectPtr<const UBTTask_ActivateAbility> Task;
+	};
+
+	struct FAbilitySystemWaitingTasks
+	{
+		TWeakObjectPtr<UAbilitySystemComponent> AbilitySystem;
+		FDelegateHandle OnAbilityEndedHandle;
+		TArray<FWaitingTask> Tasks;
+	};
+
+	/** Waiting tasks for each ability system. */
+	TMap<TObjectKey<UAbilitySystemComponent>, FAbilitySystemWaitingTasks> WaitingTasks;
+
+	void OnAbilityEnded(const FAbilityEndedData& AbilityEndedData, TObjectKey<UAbilitySystemComponent> AbilitySystemKey);
+
+	/** Unbind from an ability system once no more tasks are waiting on it. */
+	void UnbindIfNoWaitingTasks(TObjectKey<UAbilitySystemComponent> AbilitySystemKey);
+
+	struct FQueuedActivation
+	{
+		/** Unique id of this request, used to tell if it was canceled while processing the queue. */
+		uint32 RequestId = 0;
+		FGameplayAbilitySpecHandle SpecHandle;
+		TWeakObjectPtr<UAbilitySystemComponent> AbilitySystem;
+		TWeakObjectPtr<UBehaviorTreeComponent> OwnerComp;
+		TWeakObjectPtr<const UBTTask_ActivateAbility> Task;
+		double QueueTime = 0.0;
+		int32 NumFramesQueued = 0;
+	};
+
+	/** Ability activations waiting to be processed, in the order they were queued, and so sorted by request id. */
+	TArray<FQueuedActivation> QueuedActivations;
+
+	/** The id of the last queued activation. */
+	uint32 LastActivationRequestId = 0;
+
+	FBTAbilityActivationQueueMetrics ActivationQueueMetrics;
+
+	/** Activate queued abilities up to the per-frame limit, in order of priority. */
+	void ProcessQueuedActivations();
+
+	/**
+	 * Return the order in which to process queued activations, with the highest priority first.
+	 * Prioritizes AI closest to a player, and treats requests as closer the longer they have been queued.
+	 * Requests without an avatar are treated as being at the average distance of the others.
+	 */
+	void GetQueuedActivationOrder(TArray<int32>& OutOrder) const;
+};
@@ -6,14 +6,30 @@
 #include "BTTask_AbilityBase.h"
 #include "GameplayAbilitySpec.h"
 #include "Abilities/GameplayAbilityTypes.h"
+#include "UObject/ObjectKey.h"
 #include "BTTask_ActivateAbility.generated.h"
 
 class UAbilitySystemComponent;
 class UGameplayAbility;
 
 
+struct FBTActivateAbilityTaskMemory
+{
+	/** The ability being waited on. */
+	FGameplayAbilitySpecHandle SpecHandle;
+
+	/** The ability system of the ability being waited on. */
+	TWeakObjectPtr<UAbilitySystemComponent> AbilitySystem;
+
+	/** The key of AbilitySystem, still valid after it is destroyed. */
+	TObjectKey<UAbilitySystemComponent> AbilitySystemKey;
+};
+
+
 /**
  * Activate a gameplay ability and optionally wait for it to end.
+ * Not instanced, waiting for abilities to end is handled by the UBTAbilityTaskSubsystem.
+ * Activations may be queued for a later frame by the UBTAbilityTaskSubsystem, see AIAbilityActivationsPerFrame.
  */
 UCLASS()
 class EXTENDEDGAMEPLAYABILITIES_API UBTTask_ActivateAbility : public UBTTask_AbilityBase
@@ -46,18 +62,25 @@ public:
 	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
 	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
 	virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
 	virtual FString GetStaticDescription() const override;
 
-protected:
-	UPROPERTY()
-	FGameplayAbilitySpecHandle SpecHandle;
+	/** Called by the UBTAbilityTaskSubsystem when the ability this task is waiting on has ended. */
+	void OnAbilityEnded(const FAbilityEndedData& AbilityEndedData, UBehaviorTreeComponent& OwnerComp) const;
 
-	UPROPERTY()
-	TWeakObjectPtr<UAbilitySystemComponent> AbilitySystemPtr;
+	/** Called by the UBTAbilityTaskSubsystem when a queued ability activation is processed. */
+	void ActivateQueuedAbility(UBehaviorTreeComponent& OwnerComp, UAbilitySystemComponent* AbilitySystem, FGameplayAbilitySpecHandle SpecHandle) const;
 
+protected:
 	virtual FGameplayAbilitySpec* GetTargetAbilitySpec(const UAbilitySystemComponent& AbilitySystem) const;
 
-	void OnAbilityEnded(const FAbilityEndedData& AbilityEndedData, UBehaviorTreeComponent* OwnerComp);
+	/** Activate the ability and return the result of this task, which is InProgress if waiting for the ability to end. */
+	EBTNodeResult::Type ActivateAbility(UBehaviorTreeComponent& OwnerComp, UAbilitySystemComponent& AbilitySystem, FGameplayAbilitySpecHandle SpecHandle) const;
+
+	/** Stop waiting for the ability to be activated or to end, and clear the task memory. */
+	void StopWaitingForAbility(UBehaviorTreeComponent& OwnerComp, FBTActivateAbilityTaskMemory& Memory) const;
 
 	static FGameplayAbilitySpec* GetFirstAbilityWithAllTags(const UAbilitySystemComponent& AbilitySystem, const FGameplayTagContainer& RequireTags);
 };
@@ -25,7 +25,7 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Ability")
 	TSubclassOf<UGameplayAbility> AbilityClass;
 
-	/** Abilities must have all of these tags to be canceled. */
+	/** Abilities must have any of these tags to be canceled. */
 	UPROPERTY(EditAnywhere, Category = "Ability")
 	FGameplayTagContainer WithTags;
 
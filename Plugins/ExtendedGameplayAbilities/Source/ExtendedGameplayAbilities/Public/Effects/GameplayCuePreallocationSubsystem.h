@@ -0,0 +1,32 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayCuePreallocationSubsystem.generated.h"
+
+
+/**
+ * Warms the gameplay cue manager's per-class pool of notify actors for each game world, so that
+ * cue classes with NumPreallocatedInstances set are recycled from the pool instead of spawned on demand.
+ * The number of actors allocated per frame is set by UExtendedGameplayAbilitiesSettings.
+ */
+UCLASS()
+class EXTENDEDGAMEPLAYABILITIES_API UGameplayCuePreallocationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** True once the cue manager has been told to start preallocating for this world. */
+	bool bIsPreallocating = false;
+};
@@ -8,6 +8,7 @@
 #include "GameplayAbilitySpecHandle.h"
 #include "GameplayTagContainer.h"
 #include "Engine/DataAsset.h"
+#include "Engine/StreamableManager.h"
 #include "ExtendedAbilitySet.generated.h"
 
 class UExtendedAbilitySet;
@@ -24,9 +25,9 @@ struct EXTENDEDGAMEPLAYABILITIES_API FExtendedAbilitySetAbility
 {
 	GENERATED_BODY()
 
-	/** The ability to grant. */
+	/** The ability to grant. A soft reference, so it must be loaded before use, see UExtendedAbilitySet::PreloadAbilitySet. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (AllowAbstract = false))
-	TSubclassOf<UGameplayAbility> Ability = nullptr;
+	TSoftClassPtr<UGameplayAbility> Ability;
 
 	/** The level of the ability. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
@@ -46,9 +47,9 @@ struct EXTENDEDGAMEPLAYABILITIES_API FExtendedAbilitySetEffect
 {
 	GENERATED_BODY()
 
-	/** The effect to grant. */
+	/** The effect to grant. A soft reference, so it must be loaded before use, see UExtendedAbilitySet::PreloadAbilitySet. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (AllowAbstract = false))
-	TSubclassOf<UGameplayEffect> Effect = nullptr;
+	TSoftClassPtr<UGameplayEffect> Effect;
 
 	/** The level of the effect */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
@@ -64,9 +65,9 @@ struct EXTENDEDGAMEPLAYABILITIES_API FExtendedAbilitySetAttributes
 {
 	GENERATED_BODY()
 
-	/** The attribute set to grant. */
+	/** The attribute set to grant. A soft reference, so it must be loaded before use, see UExtendedAbilitySet::PreloadAbilitySet. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (AllowAbstract = false))
-	TSubclassOf<UAttributeSet> AttributeSet = nullptr;
+	TSoftClassPtr<UAttributeSet> AttributeSet;
 };
 
 
@@ -112,6 +113,9 @@ struct EXTENDEDGAMEPLAYABILITIES_API FExtendedAbilitySetHandles
 	void AddAttributeSet(const UAttributeSet* AttributeSet);
 };
 
+DECLARE_DELEGATE_OneParam(FExtendedAbilitySetGivenDelegate, const FExtendedAbilitySetHandles& /*AbilitySetHandles*/);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FExtendedAbilitySetGivenDynDelegate, const FExtendedAbilitySetHandles&, AbilitySetHandles);
+
 
 /**
  * Defines a group of abilities, effects, and attribute sets to be
@@ -135,6 +139,15 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Meta = (TitleProperty = "{AttributeSet}"))
 	TArray<FExtendedAbilitySetAttributes> GrantedAttributes;
 
+	/**
+	 * Grant all abilities and effects as a single batch. Abilities are added under one ability list lock,
+	 * aggregator updates are deferred until all effects are applied, and extended ability systems
+	 * broadcast a single OnAbilitySetGrantedEvent instead of an OnGiveAbilityEvent per ability.
+	 * Only enable this when all listeners of OnGiveAbilityEvent also handle OnAbilitySetGrantedEvent.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
+	bool bGrantAsBatch = false;
+
 	/**
 	 * Grant this ability set to an ability system.
 	 * @param AbilitySystem The ability system to receive the abilities.
@@ -146,6 +159,53 @@ public:
 	                                                       UObject* SourceObject = nullptr,
 	                                                       int32 OverrideLevel = -1) const;
 
+	/**
+	 * Replace a previously granted ability set with this one, only adding and removing what differs between them.
+	 * Abilities with the same class and dynamic tags are kept, and have their level and source object updated.
+	 * Effects with the same class and source object are kept, and have their level updated.
+	 * @param AbilitySystem The ability system that was given the old ability set.
+	 * @param OldHandles The handles from when the old ability set was given. These are reset after the swap.
+	 * @param SourceObject The object responsible for granting this ability set.
+	 * @param OverrideLevel An override to control the level for all applied abilities and effects.
+	 * @param bEndImmediately End and remove old abilities immediately, instead of removing them after they end naturally.
+	 * @param bKeepAttributeSets If true, don't remove old attribute sets that aren't part of this ability set.
+	 * @param bKeepEffectsFromOldSource If true, keep effects with the same class from any source. They still report the old source object.
+	 * @return Handles to all abilities, effects, and attributes that are granted by this ability set.
+	 */
+	virtual FExtendedAbilitySetHandles SwapAbilitySet(UAbilitySystemComponent* AbilitySystem,
+	                                                  FExtendedAbilitySetHandles& OldHandles,
+	                                                  UObject* SourceObject = nullptr,
+	                                                  int32 OverrideLevel = -1,
+	                                                  bool bEndImmediately = false,
+	                                                  bool bKeepAttributeSets = false,
+	                                                  bool bKeepEffectsFromOldSource = false) const;
+
+	/**
+	 * Grant this ability set to an ability system once all of its abilities, effects, and attribute sets are loaded.
+	 * Grants immediately if everything is already loaded. Cancel the returned handle to abort a pending grant.
+	 * @param AbilitySystem The ability system to receive the abilities.
+	 * @param SourceObject The object responsible for granting this ability set. The grant is skipped if it is destroyed while loading.
+	 * @param OverrideLevel An override to control the level for all applied abilities and effects.
+	 * @param OnGiven Called with the handles that were given, or empty handles if the grant could not happen.
+	 * @return The streamable handle for the pending load, or null if the grant happened immediately.
+	 */
+	TSharedPtr<FStreamableHandle> GiveToAbilitySystemAsync(UAbilitySystemComponent* AbilitySystem,
+	                                                       UObject* SourceObject = nullptr,
+	                                                       int32 OverrideLevel = -1,
+	                                                       FExtendedAbilitySetGivenDelegate OnGiven = FExtendedAbilitySetGivenDelegate()) const;
+
+	/**
+	 * Asynchronously load all abilities, effects, and attribute sets of this ability set.
+	 * Keep the returned handle to keep the content resident until it is granted.
+	 */
+	TSharedPtr<FStreamableHandle> PreloadAbilitySet(FStreamableDelegate OnLoaded = FStreamableDelegate()) const;
+
+	/** Return true if all abilities, effects, and attribute sets of this ability set are loaded. */
+	bool IsAbilitySetLoaded() const;
+
+	/** Add the paths of all abilities, effects, and attribute sets to load before this ability set is granted. */
+	void GetAssetsToLoad(TArray<FSoftObjectPath>& OutAssetPaths) const;
+
 	/**
 	 * Remove this ability set from an ability system.
 	 * @param AbilitySystem The ability system to remove from.
@@ -159,6 +219,29 @@ public:
 	                                     bool bKeepAttributeSets = false) const;
 
 protected:
+	/** Spawn and add an attribute set, reusing a recycled one if the ability system supports it. */
+	static UAttributeSet* SpawnAttributeSet(UAbilitySystemComponent* AbilitySystem, TSubclassOf<UAttributeSet> AttributeSetClass);
+
+	/** Remove a spawned attribute set by class, recycling it if the ability system supports it. */
+	static void DespawnAttributeSet(UAbilitySystemComponent* AbilitySystem, TSubclassOf<UAttributeSet> AttributeSetClass);
+
+	/** Spawn and add any granted attribute sets that don't already exist on the ability system. */
+	void GiveAttributeSets(UAbilitySystemComponent* AbilitySystem, FExtendedAbilitySetHandles& Handles) const;
+
+	/** Give all granted abilities to the ability system. */
+	void GiveAbilities(UAbilitySystemComponent* AbilitySystem, UObject* SourceObject, int32 OverrideLevel, FExtendedAbilitySetHandles& Handles) const;
+
+	/** Apply all granted effects to the ability system. */
+	void GiveEffects(UAbilitySystemComponent* AbilitySystem, UObject* SourceObject, int32 OverrideLevel, FExtendedAbilitySetHandles& Handles) const;
+
+	/** Keep old abilities that match granted abilities, and give or remove the rest. */
+	void SwapAbilities(UAbilitySystemComponent* AbilitySystem, const FExtendedAbilitySetHandles& OldHandles, UObject* SourceObject,
+	                   int32 OverrideLevel, bool bEndImmediately, FExtendedAbilitySetHandles& Handles) const;
+
+	/** Keep old effects that match granted effects, and apply or remove the rest. */
+	void SwapEffects(UAbilitySystemComponent* AbilitySystem, const FExtendedAbilitySetHandles& OldHandles, UObject* SourceObject,
+	                 bool bKeepEffectsFromOldSource, int32 OverrideLevel, FExtendedAbilitySetHandles& Handles) const;
+
 	/** Create and return a new ability spec to add to the ability system. */
 	virtual FGameplayAbilitySpec CreateAbilitySpec(const FExtendedAbilitySetAbility& AbilityToGrant,
 	                                               UAbilitySystemComponent* AbilitySystem,
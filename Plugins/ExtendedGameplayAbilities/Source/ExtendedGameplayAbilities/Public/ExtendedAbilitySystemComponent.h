@@ -5,10 +5,12 @@
 #include "CoreMinimal.h"
 #include "AbilitySystemComponent.h"
 #include "GameplayEffectSet.h"
+#include "UObject/ObjectKey.h"
 #include "ExtendedAbilitySystemComponent.generated.h"
 
 class UExtendedAbilitySet;
 class UExtendedAbilityTagRelationshipMapping;
+struct FExtendedAbilitySetHandles;
 
 
 /**
@@ -34,6 +36,13 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Abilities")
 	TObjectPtr<UExtendedAbilityTagRelationshipMapping> AbilityTagRelationshipMapping;
 
+	/**
+	 * Keep attribute sets that are removed with DespawnAttributeSet, and reuse them with reset values
+	 * when an attribute set of the same class is spawned again, instead of creating a new object.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Attributes")
+	bool bRecycleAttributeSets = false;
+
 	/**
 	 * Create and return an effect spec set.
 	 * The spec set can then be applied using ApplyEffectContainerToSelf on this or another ability system.
@@ -48,6 +57,12 @@ public:
 	UFUNCTION(BlueprintCallable, DisplayName = "ApplyGameplayEffectSpecSetToSelf", Category = "GameplayEffects")
 	TArray<FActiveGameplayEffectHandle> ApplyGameplayEffectSpecSetToSelf(const FGameplayEffectSpecSet& EffectSpecSet);
 
+	/** Create and add a new attribute set, or reuse a recycled one of the same class. */
+	UAttributeSet* SpawnAttributeSet(TSubclassOf<UAttributeSet> AttributeSetClass);
+
+	/** Remove a spawned attribute set, and keep it for reuse if bRecycleAttributeSets is enabled. */
+	void DespawnAttributeSet(UAttributeSet* AttributeSet);
+
 	/** Cancel all abilities with the given state tags. */
 	UFUNCTION(BlueprintCallable, Category = "Abilities")
 	void CancelAbilitiesWithState(FGameplayTagContainer WithStateTags, UGameplayAbility* IgnoreAbility);
@@ -85,4 +100,79 @@ public:
 
 	/** Called when an ability is removed. */
 	FAbilityAddOrRemoveDelegate OnRemoveAbilityEvent;
+
+	DECLARE_MULTICAST_DELEGATE_OneParam(FAbilitySetGrantedDelegate, const FExtendedAbilitySetHandles& /*AbilitySetHandles*/);
+
+	/** Called once when an ability set has been granted as a batch, instead of OnGiveAbilityEvent for each ability. */
+	FAbilitySetGrantedDelegate OnAbilitySetGrantedEvent;
+
+	/** Start granting an ability set as a batch. OnGiveAbilityEvent is not broadcast until the matching EndAbilitySetGrant. */
+	void BeginAbilitySetGrant();
+
+	/** Finish granting an ability set as a batch, and broadcast OnAbilitySetGrantedEvent. */
+	void EndAbilitySetGrant(const FExtendedAbilitySetHandles& AbilitySetHandles);
+
+	/** Return true if an ability set is currently being granted as a batch. */
+	bool IsGrantingAbilitySet() const { return AbilitySetGrantCount > 0; }
+
+	DECLARE_MULTICAST_DELEGATE(FAttributeSetsChangedDelegate);
+
+	/** Called when attribute sets are added or removed with SpawnAttributeSet and DespawnAttributeSet, or by replication. */
+	FAttributeSetsChangedDelegate OnAttributeSetsChangedEvent;
+
+	/**
+	 * Find all active effects that grant a gameplay cue.
+	 * Uses an index of active effects by gameplay cue tag, which is updated as effects are added and removed.
+	 */
+	void GetActiveEffectsGrantingGameplayCue(const FGameplayTag& GameplayCueTag, TArray<FActiveGameplayEffectHandle>& OutEffectHandles);
+
+	/**
+	 * Return the handles of all given abilities of an exact class, in the order they were given.
+	 * Uses an index that is updated as abilities are given and removed, so the view is only valid until then.
+	 */
+	TConstArrayView<FGameplayAbilitySpecHandle> GetAbilitySpecHandlesByClass(TSubclassOf<UGameplayAbility> AbilityClass) const;
+
+	/**
+	 * Return the handles of all given abilities with an asset tag matching a tag (including child tags), in the order they were given.
+	 * Uses an index that is updated as abilities are given and removed, so the view is only valid until then.
+	 */
+	TConstArrayView<FGameplayAbilitySpecHandle> GetAbilitySpecHandlesByTag(const FGameplayTag& AbilityTag) const;
+
+protected:
+	virtual void OnRep_SpawnedAttributes(const TArray<UAttributeSet*>& PreviousSpawnedAttributes) override;
+
+	/** Removed attribute sets that can be reused by SpawnAttributeSet. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAttributeSet>> RecycledAttributeSets;
+
+	/** The number of ability sets currently being granted as a batch. */
+	int32 AbilitySetGrantCount = 0;
+
+	/** Handles of given abilities by their exact class. */
+	TMap<TObjectKey<UClass>, TArray<FGameplayAbilitySpecHandle>> AbilityClassIndex;
+
+	/** Handles of given abilities by each asset tag (and its parent tags) of the ability. */
+	TMap<FGameplayTag, TArray<FGameplayAbilitySpecHandle>> AbilityTagIndex;
+
+	void AddToAbilityIndex(const FGameplayAbilitySpec& AbilitySpec);
+	void RemoveFromAbilityIndex(const FGameplayAbilitySpec& AbilitySpec);
+
+	/** Handles of active effects by each gameplay cue tag (and its parent tags) that they grant. */
+	TMap<FGameplayTag, TArray<FActiveGameplayEffectHandle>> GameplayCueEffectIndex;
+
+	/** All active effects that are in GameplayCueEffectIndex. */
+	TSet<FActiveGameplayEffectHandle> GameplayCueIndexedEffects;
+
+	/**
+	 * Index any active effects that haven't been added to GameplayCueEffectIndex yet.
+	 * Cue events for a new effect are invoked before the effect added event is broadcast,
+	 * so this keeps lookups from within gameplay cue events correct.
+	 */
+	void CatchUpGameplayCueEffectIndex();
+
+	void AddToGameplayCueEffectIndex(const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle);
+	void RemoveFromGameplayCueEffectIndex(const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle);
+
+	void OnActiveGameplayEffectAddedToSelf(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle);
+	void OnActiveGameplayEffectRemovedFromSelf(const FActiveGameplayEffect& ActiveEffect);
 };
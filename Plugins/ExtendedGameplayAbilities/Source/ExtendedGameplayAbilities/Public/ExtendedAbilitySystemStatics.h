@@ -123,6 +123,43 @@ public:
 	                                                 UObject* SourceObject = nullptr,
 	                                                 int32 OverrideLevel = -1);
 
+	/**
+	 * Replace a previously granted ability set with a new one, keeping any abilities and effects that both sets grant.
+	 * @param AbilitySystem The ability system to update.
+	 * @param OldHandles The ability set handles stored from when the old ability set was given. These are reset after the swap.
+	 * @param NewAbilitySet The ability set to grant. If null, the old ability set is just removed.
+	 * @param SourceObject The object responsible for granting the new ability set.
+	 * @param OverrideLevel An override to control the level for all applied abilities and effects.
+	 * @param bEndImmediately End and remove old abilities immediately, instead of removing them after they end naturally.
+	 * @param bKeepAttributeSets Don't remove old attribute sets that aren't part of the new ability set.
+	 * @param bKeepEffectsFromOldSource Keep effects with the same class from any source. They still report the old source object.
+	 * @return Handles to all abilities, effects, and attributes that are granted by the new ability set.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Gameplay Abilities")
+	static FExtendedAbilitySetHandles SwapAbilitySet(UAbilitySystemComponent* AbilitySystem,
+	                                                 UPARAM(ref) FExtendedAbilitySetHandles& OldHandles,
+	                                                 UExtendedAbilitySet* NewAbilitySet,
+	                                                 UObject* SourceObject = nullptr,
+	                                                 int32 OverrideLevel = -1,
+	                                                 bool bEndImmediately = false,
+	                                                 bool bKeepAttributeSets = false,
+	                                                 bool bKeepEffectsFromOldSource = false);
+
+	/**
+	 * Grant an ability set to an ability system once all of its abilities, effects, and attribute sets have loaded asynchronously.
+	 * @param AbilitySystem The ability system to receive the abilities.
+	 * @param AbilitySet The ability set to grant.
+	 * @param OnGiven Called with the handles that were given, or empty handles if the grant could not happen.
+	 * @param SourceObject The object responsible for granting the ability set.
+	 * @param OverrideLevel An override to control the level for all applied abilities and effects.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Gameplay Abilities")
+	static void GiveAbilitySetAsync(UAbilitySystemComponent* AbilitySystem,
+	                                UExtendedAbilitySet* AbilitySet,
+	                                const FExtendedAbilitySetGivenDynDelegate& OnGiven,
+	                                UObject* SourceObject = nullptr,
+	                                int32 OverrideLevel = -1);
+
 	/**
 	 * Remove an ability set from an ability system.
 	 * This may remove an attribute set that could still be important to some other abilities / effects,
@@ -153,9 +190,21 @@ public:
 	                                        float OldRelatedValue, float NewRelatedValue,
 	                                        bool bRound = true, bool bClamp = true);
 
+	/** Same as AdjustProportionalAttribute, for when the attribute's current base value is already known. */
+	static void AdjustProportionalAttributeBase(UAttributeSet* AttributeSet, const FGameplayAttribute& Attribute, float CurrentBaseValue,
+	                                            float OldRelatedValue, float NewRelatedValue,
+	                                            bool bRound = true, bool bClamp = true);
+
 	/** Return the base value for an attribute using an attribute set. */
 	static float GetNumericAttributeBase(const UAttributeSet* AttributeSet, const FGameplayAttribute& Attribute);
 
+	/** Return the base value of an attribute data member of an attribute set, without property reflection. */
+	template <typename AttributeSetType>
+	FORCEINLINE static float GetNumericAttributeBase(const AttributeSetType* AttributeSet, FGameplayAttributeData AttributeSetType::* AttributeMember)
+	{
+		return (AttributeSet->*AttributeMember).GetBaseValue();
+	}
+
 	/**
 	 * Return the value of a data registry curve at an input time/level/value.
 	 * Return the DefaultValue if the curve is not found.
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "AttributeSet.h"
+#include "ExtendedGameplayAttributeAccessors.h"
 #include "ExtendedAttributeSet.generated.h"
 
 
@@ -17,6 +18,88 @@ struct FExtendedMaxAttributeRules
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	bool bProportional = false;
+
+	bool operator==(const FExtendedMaxAttributeRules& Other) const
+	{
+		return MaxAttribute == Other.MaxAttribute && bProportional == Other.bProportional;
+	}
+};
+
+
+/**
+ * The clamping rules of an attribute set, compiled from its MaxAttributesMap and MinMaxValuesMap
+ * into a flat array indexed by attribute property offset. Shared by all instances of a class.
+ */
+struct EXTENDEDGAMEPLAYABILITIES_API FExtendedAttributeSetRules
+{
+	struct FAttributeRules
+	{
+		const FProperty* Property = nullptr;
+
+		/** Offset of the attribute data in the attribute set, or INDEX_NONE if it's a float property. */
+		int32 DataOffset = INDEX_NONE;
+
+		FGameplayAttribute MaxAttribute;
+		int32 MaxAttributeDataOffset = INDEX_NONE;
+		bool bHasMaxAttribute = false;
+		bool bProportional = false;
+
+		bool bHasValueRange = false;
+		float MinValue = 0.f;
+		float MaxValue = 0.f;
+
+		/** Attributes that use this attribute as their max value. */
+		TArray<FGameplayAttribute, TInlineAllocator<1>> DependentAttributes;
+	};
+
+	/** Return the base value of an attribute, reading it directly when it's attribute data. */
+	FORCEINLINE static float GetBaseValue(const UAttributeSet* AttributeSet, const FGameplayAttribute& Attribute, int32 DataOffset)
+	{
+		return DataOffset != INDEX_NONE
+			       ? ExtendedGameplayAttributes::GetDataAtOffset(AttributeSet, DataOffset).GetBaseValue()
+			       : Attribute.GetNumericValue(AttributeSet);
+	}
+
+	/** Return the current value of an attribute, reading it directly when it's attribute data. */
+	FORCEINLINE static float GetCurrentValue(const UAttributeSet* AttributeSet, const FGameplayAttribute& Attribute, int32 DataOffset)
+	{
+		return DataOffset != INDEX_NONE
+			       ? ExtendedGameplayAttributes::GetDataAtOffset(AttributeSet, DataOffset).GetCurrentValue()
+			       : Attribute.GetNumericValue(AttributeSet);
+	}
+
+	/** Return the rules for an attribute, or null if it has none. */
+	FORCEINLINE const FAttributeRules* Find(const FGameplayAttribute& Attribute) const
+	{
+		const FProperty* Property = Attribute.GetUProperty();
+		if (!Property)
+		{
+			return nullptr;
+		}
+
+		const int32 Slot = Property->GetOffset_ForInternal() / sizeof(float);
+		const int32 RulesIdx = RulesIndices.IsValidIndex(Slot) ? RulesIndices[Slot] : INDEX_NONE;
+		return RulesIdx != INDEX_NONE && Rules[RulesIdx].Property == Property ? &Rules[RulesIdx] : nullptr;
+	}
+
+	/** Compile rules from max attributes and min/max values. */
+	static TSharedRef<const FExtendedAttributeSetRules> Compile(const TMap<FGameplayAttribute, FExtendedMaxAttributeRules>& MaxAttributesMap,
+	                                                            const TMap<FGameplayAttribute, FFloatRange>& MinMaxValuesMap);
+
+	/** Return the shared rules for an attribute set class, compiled from its default object. */
+	static TSharedRef<const FExtendedAttributeSetRules> GetForClass(const UClass* AttributeSetClass);
+
+	/** Clear all shared class rules, e.g. after class defaults have changed. */
+	static void ClearClassCache();
+
+	/** Return rules for an attribute set with no clamping. */
+	static const FExtendedAttributeSetRules& GetEmpty();
+
+protected:
+	TArray<FAttributeRules> Rules;
+
+	/** Index into Rules for each attribute, by property offset in 4-byte slots. */
+	TArray<int16> RulesIndices;
 };
 
 
@@ -29,11 +112,14 @@ class EXTENDEDGAMEPLAYABILITIES_API UExtendedAttributeSet : public UAttributeSet
 	GENERATED_BODY()
 
 public:
-	/** Map of attributes to their max value attributes, for attributed-based clamping. */
+	/**
+	 * Map of attributes to their max value attributes, for attributed-based clamping.
+	 * Compiled into rules that are shared by all instances whose maps match their class defaults.
+	 */
 	UPROPERTY(EditAnywhere)
 	TMap<FGameplayAttribute, FExtendedMaxAttributeRules> MaxAttributesMap;
 
-	/** Map of attributes to their min/max values, for non-attribute based clamping. */
+	/** Map of attributes to their min/max values, for non-attribute based clamping. See MaxAttributesMap. */
 	UPROPERTY(EditAnywhere)
 	TMap<FGameplayAttribute, FFloatRange> MinMaxValuesMap;
 
@@ -48,6 +134,13 @@ public:
 	/** Set the minimum and maximum values for an attribute. */
 	void SetAttributeValueRange(const FGameplayAttribute& Attribute, float Min, float Max);
 
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+	virtual void PostDuplicate(bool bDuplicateForPIE) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
 	virtual void PreAttributeBaseChange(const FGameplayAttribute& Attribute, float& NewValue) const override;
 	virtual void PreAttributeChange(const FGameplayAttribute& Attribute, float& NewValue) override;
 	virtual void PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) override;
@@ -63,4 +156,26 @@ public:
 
 	/** Set the default base and current value of an attribute. */
 	static void InitAttribute(FGameplayAttributeData& AttributeData, float Value);
+
+	/**
+	 * Reset all attribute data of an attribute set to that of its archetype, e.g. before it is reused.
+	 * Extended attribute sets also reset any other state in ResetRuntimeState.
+	 */
+	static void ResetAttributeValues(UAttributeSet* AttributeSet);
+
+	/** Reset any state other than attribute data when this attribute set is reset for reuse. */
+	virtual void ResetRuntimeState() {}
+
+	/** Return the compiled clamping rules for this attribute set. */
+	const FExtendedAttributeSetRules& GetRules() const { return Rules.IsValid() ? *Rules : FExtendedAttributeSetRules::GetEmpty(); }
+
+protected:
+	/** The compiled clamping rules, either shared by the class or specific to this instance. */
+	TSharedPtr<const FExtendedAttributeSetRules> Rules;
+
+	/** Recompile this instance's rules after its rule maps have changed. */
+	void UpdateInstanceRules();
+
+	/** Use the shared class rules if the rule maps match the class defaults, otherwise compile rules for this instance. */
+	void UpdateRulesFromMaps();
 };
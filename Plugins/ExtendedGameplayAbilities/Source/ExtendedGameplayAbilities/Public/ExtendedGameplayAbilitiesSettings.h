@@ -25,4 +25,25 @@ public:
 
 	UPROPERTY(Config, EditAnywhere, NoClear, Meta = (AllowAbstract = false), Category = "General")
 	TSubclassOf<UGameplayEffect> DefaultDynamicCooldownEffectClass;
+
+	/**
+	 * The maximum number of gameplay cue notify actors to preallocate each frame, for classes
+	 * that have NumPreallocatedInstances set. Set to 0 to disable preallocation.
+	 */
+	UPROPERTY(Config, EditAnywhere, Meta = (ClampMin = "0"), Category = "GameplayCues")
+	int32 GameplayCuePreallocationsPerFrame = 1;
+
+	/**
+	 * The maximum number of abilities that behavior tree tasks can activate each frame.
+	 * Further activations are queued until a later frame. Set to 0 to always activate immediately.
+	 */
+	UPROPERTY(Config, EditAnywhere, Meta = (ClampMin = "0"), Category = "AI")
+	int32 AIAbilityActivationsPerFrame = 0;
+
+	/**
+	 * Activate queued abilities for AI closest to a player first.
+	 * Queued abilities are treated as closer the longer they have waited, so that every AI is activated eventually.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "AI")
+	bool bPrioritizeAIAbilityActivationsByDistance = true;
 };
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "DataRegistryId.h"
 #include "EnhancedInputSubsystemInterface.h"
 #include "GameplayEffectSet.h"
 #include "Abilities/GameplayAbility.h"
@@ -10,6 +11,7 @@
 
 class ACharacter;
 class APawn;
+class UDataRegistry;
 class UInputComponent;
 class UInputMappingContext;
 
@@ -43,6 +45,19 @@ struct FDynamicGameplayAbilityCooldown
 };
 
 
+/**
+ * A data registry value cached by an ability for its current level.
+ */
+struct FExtendedCachedAbilityStat
+{
+	float Value = 0.f;
+
+	/** The registry the value came from, and its cache version at the time, to detect reloads. */
+	TWeakObjectPtr<const UDataRegistry> Registry;
+	int32 CacheVersion = INDEX_NONE;
+};
+
+
 /**
  * Extends the base gameplay ability with a reusable gameplay effect set map, functions
  * for working with effect sets, and other optional features like auto activation when granted.
@@ -92,6 +107,10 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "GameplayEffects")
 	TMap<FGameplayTag, FGameplayEffectSet> EffectSetMap;
 
+	/** Data registry stats used by this ability, which are cached together when the ability is granted. See GetAbilityStat. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Stats")
+	TArray<FDataRegistryId> AbilityStatIds;
+
 	/**
 	 * Return the duration to use a for a dynamic cooldown.
 	 * By default this returns the duration defined in DynamicCooldown, but can be implemented to
@@ -117,6 +136,7 @@ public:
 	                                               const FGameplayTagContainer* SourceTags = nullptr, const FGameplayTagContainer* TargetTags = nullptr,
 	                                               FGameplayTagContainer* OptionalRelevantTags = nullptr) const override;
 
+	virtual void OnGiveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) override;
 	virtual void OnAvatarSet(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) override;
 
 	/** Called when the avatar of the owning ability system has been set. */
@@ -148,10 +168,21 @@ public:
 	                                                              const FGameplayAbilityActivationInfo ActivationInfo,
 	                                                              const FGameplayEffectSpecSet& EffectSpecSet);
 
-	/** Return the value of a curve table at this ability's level. */
+	/**
+	 * Return the value of a curve table at this ability's level.
+	 * Values are cached on instanced abilities until the level changes or the registry is reloaded.
+	 */
 	UFUNCTION(BlueprintPure, Meta = (HideSelfPin = true, AdvancedDisplay = "1"), Category = "Ability")
 	float GetAbilityStat(FDataRegistryId Id, float DefaultValue = 0.f) const;
 
+	/** Cache the values of all AbilityStatIds at this ability's level. Called automatically when granted. */
+	UFUNCTION(BlueprintCallable, Category = "Ability")
+	void PrefetchAbilityStats() const;
+
+	/** Clear all cached ability stats, so they are retrieved again on next use. */
+	UFUNCTION(BlueprintCallable, Category = "Ability")
+	void ClearAbilityStatCache() const;
+
 	/** Return the avatar as a pawn from the actor info. */
 	UFUNCTION(BlueprintPure, Category = "Ability")
 	APawn* GetPawnFromActorInfo() const;
@@ -217,4 +248,13 @@ protected:
 
 	virtual void InitializeInputComponent();
 	virtual void UninitializeInputComponent();
+
+	/** Cached ability stats for the ability level CachedAbilityStatsLevel. */
+	mutable TMap<FDataRegistryId, FExtendedCachedAbilityStat> CachedAbilityStats;
+
+	/** The ability level that CachedAbilityStats were retrieved for. */
+	mutable int32 CachedAbilityStatsLevel = INDEX_NONE;
+
+	/** Return a cached ability stat, retrieving it if not cached or out of date. Returns null if the stat was not found. */
+	const FExtendedCachedAbilityStat* FindOrCacheAbilityStat(const FDataRegistryId& Id, int32 AbilityLevel) const;
 };
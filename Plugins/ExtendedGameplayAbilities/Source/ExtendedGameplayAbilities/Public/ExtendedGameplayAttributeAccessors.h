@@ -13,3 +13,49 @@
 	GAMEPLAYATTRIBUTE_VALUE_GETTER(PropertyName) \
 	GAMEPLAYATTRIBUTE_VALUE_SETTER(PropertyName) \
 	GAMEPLAYATTRIBUTE_VALUE_INITTER(PropertyName)
+
+
+namespace ExtendedGameplayAttributes
+{
+	/** Return the attribute data at a byte offset in an attribute set. */
+	FORCEINLINE const FGameplayAttributeData& GetDataAtOffset(const UAttributeSet* AttributeSet, int32 Offset)
+	{
+		return *reinterpret_cast<const FGameplayAttributeData*>(reinterpret_cast<const uint8*>(AttributeSet) + Offset);
+	}
+}
+
+
+/** Define the offset of an attribute in its attribute set, e.g. GetHPOffset(). */
+#define GAMEPLAYATTRIBUTE_OFFSET_GETTER(ClassName, PropertyName) \
+	FORCEINLINE static int32 Get##PropertyName##Offset() \
+	{ \
+		return STRUCT_OFFSET(ClassName, PropertyName); \
+	}
+
+/** Define static base and current value getters that read the attribute data directly, e.g. GetHPBaseValue(AttributeSet). */
+#define GAMEPLAYATTRIBUTE_STATIC_VALUE_GETTERS(ClassName, PropertyName) \
+	FORCEINLINE static float Get##PropertyName##BaseValue(const ClassName* AttributeSet) \
+	{ \
+		return AttributeSet->PropertyName.GetBaseValue(); \
+	} \
+	FORCEINLINE static float Get##PropertyName##CurrentValue(const ClassName* AttributeSet) \
+	{ \
+		return AttributeSet->PropertyName.GetCurrentValue(); \
+	}
+
+/** Define a member getter for the base value of an attribute, e.g. GetHPBase(). */
+#define GAMEPLAYATTRIBUTE_BASE_VALUE_GETTER(PropertyName) \
+	FORCEINLINE float Get##PropertyName##Base() const \
+	{ \
+		return PropertyName.GetBaseValue(); \
+	}
+
+/**
+ * The standard accessors, plus getters that don't use property reflection.
+ * Only for FGameplayAttributeData properties, not float properties.
+ */
+#define EXTENDED_GAMEPLAYATTRIBUTE_ACCESSORS(ClassName, PropertyName) \
+	GAMEPLAYATTRIBUTE_ACCESSORS(ClassName, PropertyName) \
+	GAMEPLAYATTRIBUTE_OFFSET_GETTER(ClassName, PropertyName) \
+	GAMEPLAYATTRIBUTE_STATIC_VALUE_GETTERS(ClassName, PropertyName) \
+	GAMEPLAYATTRIBUTE_BASE_VALUE_GETTER(PropertyName)
@@ -9,6 +9,9 @@
 /**
  * A AGameplayCueNotify_Looping with a bug fix that prevents OnRemove from properly being
  * called while GameplayCueNotifyTagCheckOnRemove is enabled (on by default).
+ *
+ * Actors that are re-added while finishing after OnRemove are reused without being recycled.
+ * Set NumPreallocatedInstances to warm a pool of actors for this class, see UGameplayCuePreallocationSubsystem.
  */
 UCLASS(Blueprintable, NotPlaceable, Category = "GameplayCueNotify", Meta = (DisplayName = "Extended GCN Looping"))
 class EXTENDEDGAMEPLAYABILITIES_API AExtendedGameplayCueNotify_Looping : public AGameplayCueNotify_Looping
@@ -28,4 +31,8 @@ public:
 
 	virtual void HandleGameplayCue(AActor* MyTarget, EGameplayCueEvent::Type EventType, const FGameplayCueParameters& Parameters) override;
 	virtual bool WhileActive_Implementation(AActor* MyTarget, const FGameplayCueParameters& Parameters) override;
+
+protected:
+	/** Cancel any pending finish from a previous OnRemove, and allow all events to be handled again. */
+	void ReviveAfterRemove();
 };
@@ -9,6 +9,7 @@
 
 class UExtendedAbilitySystemComponent;
 class UVM_GameplayAbility;
+struct FExtendedAbilitySetHandles;
 
 
 /**
@@ -63,5 +64,6 @@ protected:
 	virtual void PreSystemChange() override;
 	virtual void PostSystemChange() override;
 	virtual void OnGiveAbility(FGameplayAbilitySpec& GameplayAbilitySpec);
+	virtual void OnAbilitySetGranted(const FExtendedAbilitySetHandles& AbilitySetHandles);
 	virtual void OnRemoveAbility(FGameplayAbilitySpec& GameplayAbilitySpec);
 };
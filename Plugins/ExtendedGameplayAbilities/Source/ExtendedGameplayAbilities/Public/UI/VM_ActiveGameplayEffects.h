@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "AbilitySystemViewModelBase.h"
 #include "GameplayEffect.h"
+#include "UObject/ObjectKey.h"
 #include "VM_ActiveGameplayEffects.generated.h"
 
 class UGameplayEffectUIData;
@@ -37,13 +38,46 @@ public:
 
 	/** Return all active gameplay effects. */
 	UFUNCTION(BlueprintPure, FieldNotify)
-	TArray<FActiveGameplayEffectHandle> GetActiveEffects() const;
+	const TArray<FActiveGameplayEffectHandle>& GetActiveEffects() const;
 
-	/** Return a list of view models for all active gameplay effects. */
+	/**
+	 * Return a list of view models for all active gameplay effects.
+	 * View models are reused for effects that remain active between calls.
+	 */
 	UFUNCTION(BlueprintPure, FieldNotify)
-	TArray<UVM_ActiveGameplayEffect*> GetActiveEffectViewModels() const;
+	const TArray<UVM_ActiveGameplayEffect*>& GetActiveEffectViewModels() const;
+
+	/** Return true if an active effect matches the query and required UI data class. */
+	virtual bool ShouldIncludeEffect(const FActiveGameplayEffect& ActiveEffect) const;
 
 protected:
+	/** The cached handles of all included active effects, valid when bActiveEffectsDirty is false. */
+	mutable TArray<FActiveGameplayEffectHandle> ActiveEffects;
+
+	/** True when ActiveEffects must be rebuilt from the ability system on the next read. */
+	mutable bool bActiveEffectsDirty = true;
+
+	/** The view model for each of ActiveEffects, by effect handle. */
+	UPROPERTY(Transient)
+	mutable TMap<FActiveGameplayEffectHandle, TObjectPtr<UVM_ActiveGameplayEffect>> ViewModelsByHandle;
+
+	/** The view models for each of ActiveEffects in order, updated on the next read when bViewModelsDirty is true. */
+	mutable TArray<UVM_ActiveGameplayEffect*> ActiveEffectViewModels;
+
+	/** True when ActiveEffectViewModels must be updated on the next read. */
+	mutable bool bViewModelsDirty = true;
+
+	/** Cached results of whether a gameplay effect has a RequiredUIDataClass component. */
+	mutable TMap<TObjectKey<UGameplayEffect>, bool> HasRequiredUIDataCache;
+
+	/** Return true if the effect has a component of RequiredUIDataClass, using cached results when possible. */
+	bool HasRequiredUIData(const UGameplayEffect* EffectDef) const;
+
+	/** Mark cached active effects as dirty, and broadcast changes. */
+	void InvalidateActiveEffects();
+
+	void BroadcastActiveEffectsChanged();
+
 	virtual void PreSystemChange() override;
 	virtual void PostSystemChange() override;
 
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "AbilitySystemViewModelBase.h"
 #include "GameplayAbilitySpecHandle.h"
+#include "GameplayEffect.h"
 #include "GameplayTagContainer.h"
 #include "Abilities/GameplayAbilityTypes.h"
 #include "VM_GameplayAbility.generated.h"
@@ -14,6 +15,32 @@ class UGameplayAbility;
 struct FGameplayAbilitySpec;
 
 
+/**
+ * Immutable info about a gameplay ability class that view models need frequently,
+ * computed once per class from the ability CDO and shared between all view models.
+ */
+struct EXTENDEDGAMEPLAYABILITIES_API FGameplayAbilityClassViewInfo
+{
+	/** The cooldown tags of the ability. */
+	FGameplayTagContainer CooldownTags;
+
+	/** Query matching any active effect that grants one of the cooldown tags. */
+	FGameplayEffectQuery CooldownEffectQuery;
+
+	/** All attributes modified by the ability's cost effect. */
+	TArray<FGameplayAttribute> CostAttributes;
+
+	/** Return the shared info for an ability, creating it if this is the first request for its class. */
+	static TSharedRef<const FGameplayAbilityClassViewInfo> Get(const UGameplayAbility* AbilityCDO);
+
+	/** Return info with no cooldown tags or cost attributes, for use when there is no ability. */
+	static const FGameplayAbilityClassViewInfo& GetEmpty();
+
+	/** Clear all cached info, e.g. after classes have been recompiled. */
+	static void ClearCache();
+};
+
+
 /**
  * A view model representing a gameplay ability granted to an ability system.
  */
@@ -48,11 +75,11 @@ public:
 	bool IsOnCooldown() const;
 
 	UFUNCTION(BlueprintPure, FieldNotify)
-	FGameplayTagContainer GetCooldownTags() const;
+	const FGameplayTagContainer& GetCooldownTags() const;
 
 	/** Return all gameplay attributes that are used in the abilities Cost effect. */
 	UFUNCTION(BlueprintPure, FieldNotify)
-	TArray<FGameplayAttribute> GetCostAttributes() const;
+	const TArray<FGameplayAttribute>& GetCostAttributes() const;
 
 	/**
 	 * Get the currently active cooldown gameplay effect for this ability, if any.
@@ -73,6 +100,9 @@ public:
 
 	FGameplayAbilitySpec* GetAbilitySpec() const;
 
+	/** Return the shared class info for the ability, or empty info if there is no ability. */
+	const FGameplayAbilityClassViewInfo& GetAbilityClassViewInfo() const;
+
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FCooldownEffectAppliedDynDelegate, FActiveGameplayEffectHandle, EffectHandle);
 
 	/** Called when a cooldown effect for this ability is applied. */
@@ -80,6 +110,9 @@ public:
 	FCooldownEffectAppliedDynDelegate OnCooldownEffectAppliedEvent;
 
 protected:
+	/** The shared class info for the current ability, resolved on first use after the ability spec handle changes. */
+	mutable TSharedPtr<const FGameplayAbilityClassViewInfo> AbilityClassViewInfo;
+
 	/** Cooldown tags that were registered for change events. */
 	FGameplayTagContainer RegisteredCooldownTags;
 
@@ -35,7 +35,25 @@ public:
 	float GetValue() const;
 
 protected:
+	/**
+	 * The last known value of the attribute, updated when bound and from OnAttributeValueChanged,
+	 * so that GetValue doesn't need to search the ability system's attribute sets on every read.
+	 */
+	mutable float CachedValue = 0.f;
+
+	/**
+	 * True when CachedValue is up to date and can be returned directly. A missing attribute is cached as 0
+	 * when the ability system reports attribute set changes, and is otherwise looked up again on every read.
+	 */
+	mutable bool bHasCachedValue = false;
+
+	/** Update CachedValue from the ability system. */
+	void UpdateCachedValue() const;
+
 	virtual void PreSystemChange() override;
 	virtual void PostSystemChange() override;
 	virtual void OnAttributeValueChanged(const FOnAttributeChangeData& ChangeData);
+
+	/** Update the value, since the attribute's set may have been added or removed. */
+	void OnAttributeSetsChanged();
 };
@@ -0,0 +1,60 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AbilitySystemViewModelBase.h"
+#include "AttributeSet.h"
+#include "GameplayEffectTypes.h"
+#include "VM_GameplayAttributes.generated.h"
+
+
+/**
+ * A viewmodel for displaying multiple gameplay attributes of an ability system.
+ * Values are stored contiguously in the same order as Attributes, for use in list-style UIs.
+ */
+UCLASS(BlueprintType)
+class EXTENDEDGAMEPLAYABILITIES_API UVM_GameplayAttributes : public UAbilitySystemViewModelBase
+{
+	GENERATED_BODY()
+
+protected:
+	/** The gameplay attributes. */
+	UPROPERTY(BlueprintReadWrite, FieldNotify, Setter)
+	TArray<FGameplayAttribute> Attributes;
+
+public:
+	UFUNCTION(BlueprintSetter)
+	void SetAttributes(const TArray<FGameplayAttribute>& NewAttributes);
+
+	UFUNCTION(BlueprintCallable)
+	void SetAbilitySystemAndAttributes(UAbilitySystemComponent* NewAbilitySystem, const TArray<FGameplayAttribute>& NewAttributes);
+
+	const TArray<FGameplayAttribute>& GetAttributes() const { return Attributes; }
+
+	/** Return the current value of all attributes, in the same order as Attributes. */
+	UFUNCTION(BlueprintPure, FieldNotify)
+	const TArray<float>& GetValues() const { return Values; }
+
+	/** Return the current value of the attribute at an index. */
+	UFUNCTION(BlueprintPure)
+	float GetValueAt(int32 Index) const;
+
+	/** Return the current value of an attribute, or 0 if it isn't bound to this view model. */
+	UFUNCTION(BlueprintPure)
+	float GetAttributeValue(FGameplayAttribute InAttribute) const;
+
+protected:
+	/** The current value of each attribute, updated when bound and from OnAttributeValueChanged. */
+	TArray<float> Values;
+
+	/** Update all values from the ability system. */
+	void UpdateValues();
+
+	virtual void PreSystemChange() override;
+	virtual void PostSystemChange() override;
+	virtual void OnAttributeValueChanged(const FOnAttributeChangeData& ChangeData);
+
+	/** Update all values, since attribute sets may have been added or removed. */
+	void OnAttributeSetsChanged();
+};
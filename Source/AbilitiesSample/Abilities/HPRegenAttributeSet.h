@@ -22,7 +22,7 @@ public:
 	/** How much HP to regenerate each second. */
 	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_HPRegen, Category = "Health")
 	FGameplayAttributeData HPRegen;
-	GAMEPLAYATTRIBUTE_ACCESSORS(UHPRegenAttributeSet, HPRegen)
+	EXTENDED_GAMEPLAYATTRIBUTE_ACCESSORS(UHPRegenAttributeSet, HPRegen)
 	UFUNCTION()
 	virtual void OnRep_HPRegen(FGameplayAttributeData& OldValue);
 };
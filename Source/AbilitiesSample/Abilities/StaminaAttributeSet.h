@@ -22,21 +22,21 @@ public:
 	/** How much Stamina to regenerate each second. */
 	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_Stamina, Category = "Stamina")
 	FGameplayAttributeData Stamina;
-	GAMEPLAYATTRIBUTE_ACCESSORS(UStaminaAttributeSet, Stamina)
+	EXTENDED_GAMEPLAYATTRIBUTE_ACCESSORS(UStaminaAttributeSet, Stamina)
 	UFUNCTION()
 	virtual void OnRep_Stamina(FGameplayAttributeData& OldValue);
 
 	/** How much Stamina to regenerate each second. */
 	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_MaxStamina, Category = "Stamina")
 	FGameplayAttributeData MaxStamina;
-	GAMEPLAYATTRIBUTE_ACCESSORS(UStaminaAttributeSet, MaxStamina)
+	EXTENDED_GAMEPLAYATTRIBUTE_ACCESSORS(UStaminaAttributeSet, MaxStamina)
 	UFUNCTION()
 	virtual void OnRep_MaxStamina(FGameplayAttributeData& OldValue);
 
 	/** How much Stamina to regenerate each second. */
 	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_StaminaRegen, Category = "Stamina")
 	FGameplayAttributeData StaminaRegen;
-	GAMEPLAYATTRIBUTE_ACCESSORS(UStaminaAttributeSet, StaminaRegen)
+	EXTENDED_GAMEPLAYATTRIBUTE_ACCESSORS(UStaminaAttributeSet, StaminaRegen)
 	UFUNCTION()
 	virtual void OnRep_StaminaRegen(FGameplayAttributeData& OldValue);
 };